@@ -2,21 +2,64 @@
 /**
  * @file adc.c
  * @brief ADC12 A0 sampling with change-threshold publishing and ISR wake.
+ *
+ * adc_init() only configures the module; sampling runs between
+ * adc_start() and adc_stop(), which the power manager calls for the
+ * first and last PERIPH_ADC12 client.
+ *
+ * Publishing policy: either a fixed change threshold against the last
+ * published value, or the CUSUM mean-shift detector (cusum.c), which
+ * publishes only on statistically significant level changes. Published
+ * values queue up (oldest first) for the ADC pipeline to take in one
+ * batch; when the queue is full the newest replaces the last queued
+ * value, so the latest level is never lost.
+ *
+ * Streaming: every Nth sample is also queued with its timestamp for
+ * poll_adc_stream to send as binary frames (stream.h); samples that
+ * find the queue full are counted as drops.
  */
 
 #include <msp430.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include "clock.h"
+#include "adc.h"
+#include "cusum.h"
+#include "analyzer.h"
+#include "record.h"
+#include "timestamp.h"
+#include "nest.h"
+#include "param.h"
+#include "usbram.h"
 
 
 
-#define ADC_CHANGE_THRESHHOLD 100        /* raw counts; 12-bit ADC */
+#define ADC_STREAM_QUEUE 64              /* power of two; in USB RAM */
+#define ADC_PUBLISH_QUEUE 16             /* power of two; holds more than a PIPE_BATCH */
 
 
-static volatile bool published = false;         /* false => new value pending */
-static volatile uint16_t publish_value = 0; 
+static volatile uint16_t publish_queue[ADC_PUBLISH_QUEUE];
+static volatile uint8_t publish_head = 0;       /* written by the ISR */
+static volatile uint8_t publish_tail = 0;       /* written by main */
+static volatile uint16_t publish_value = 0;     /* last published (telemetry) */
+static volatile uint16_t change_threshold = 100;    /* raw counts; 12-bit ADC */
+static volatile adc_publish_mode_t publish_mode = ADC_PUBLISH_THRESHOLD;
+static volatile int8_t change_dir = 0;          /* CUSUM: +1/-1 pending, 0 none */
+static bool slow = false;                       /* ADC12 clocked from ACLK */
 
-/* Configure ADC12 to continuously sample A0 (P6.0) with MEM0 interrupt */
+typedef struct {
+    uint16_t stamp;
+    uint16_t value;
+} stream_sample_t;
+
+static stream_sample_t stream_queue[ADC_STREAM_QUEUE] USBRAM;
+static volatile uint8_t stream_head = 0;        /* written by the ISR */
+static volatile uint8_t stream_tail = 0;        /* written by main */
+static volatile uint16_t stream_decimate = 0;   /* 0: not streaming */
+static uint16_t stream_phase = 0;
+static volatile uint16_t stream_drops = 0;
+
+/* Configure ADC12 to continuously sample A0 (P6.0) with MEM0 interrupt; left off */
 void adc_init() {
 
     /* Route P6.0 to ADC input A0 */
@@ -64,39 +107,205 @@ void adc_init() {
     ADC12MCTL0 &= ~(ADC12SREF0 | ADC12SREF1 | ADC12SREF2); /* AVCC/AVSS */
     ADC12MCTL0 &= ~(ADC12INCH0 | ADC12INCH1 | ADC12INCH2 | ADC12INCH3); /* A0 */
 
-    /* Turn ADC on, enable conversions, and start conversion loop */
+    adc_clock_changed();      /* dividers for the current SMCLK */
+}
+
+/* Turn ADC on, enable conversions, and start conversion loop */
+void adc_start() {
     ADC12CTL0 |= ADC12ON;
     ADC12CTL0 |= ADC12ENC;
     ADC12CTL0 |= ADC12SC;
+}
+
+/*
+ * Stop immediately (CONSEQ = 0 then ENC = 0 aborts the repeat sequence),
+ * then power the core down. P6.0 stays on the analog function, which is
+ * already its lowest-leakage state.
+ */
+void adc_stop() {
+    ADC12CTL1 &= ~ADC12CONSEQ_2;
+    ADC12CTL0 &= ~(ADC12ENC | ADC12SC);
+    while (ADC12CTL1 & ADC12BUSY);
+    ADC12CTL0 &= ~ADC12ON;
+    ADC12CTL1 |= ADC12CONSEQ_2;     /* restore mode for the next start */
+    ADC12IFG = 0;
+}
 
+/*
+ * Keep the ADC12 clock (and so the sample rate) at SMCLK-slow rates when
+ * SMCLK is boosted: /1 at ~1 MHz, predivide /4 and divide /4 at ~16 MHz.
+ * In slow mode the ADC runs from ACLK (~230 samples/s), which keeps
+ * running in LPM3.
+ */
+void adc_clock_changed() {
+    bool running = (ADC12CTL0 & ADC12ON) != 0;
 
+    ADC12CTL0 &= ~ADC12ENC;                 /* dividers need ENC = 0 */
+    ADC12CTL1 &= ~(ADC12DIV0 | ADC12DIV1 | ADC12DIV2 | ADC12SSEL0 | ADC12SSEL1);
+    ADC12CTL1 |= slow ? ADC12SSEL0 : (ADC12SSEL0 | ADC12SSEL1);   /* ACLK : SMCLK */
+    ADC12CTL2 &= ~ADC12PDIV;
+    if (!slow && clock_boosted()) {
+        ADC12CTL2 |= ADC12PDIV;             /* /4 */
+        ADC12CTL1 |= ADC12DIV_3;            /* /4 */
+    }
+    if (running) {
+        ADC12CTL0 |= ADC12ENC;
+        ADC12CTL0 |= ADC12SC;               /* restart repeat sequence */
+    }
 }
 
-/* Return true once per new value; copy into *external_value */
+/* Slow (ACLK) or normal (SMCLK) sampling; applies immediately */
+void adc_set_slow(bool on) {
+    slow = on;
+    adc_clock_changed();
+}
+
+bool adc_needs_smclk() {
+    return !slow;
+}
+
+/* Oldest published value not yet taken */
 bool poll_adc_value(uint16_t *external_value){
-    if(!published) {
-         *external_value = publish_value;
-        published = true;   /* mark value as consumed */
-        return true; 
+    uint8_t tail = publish_tail;
+    if (tail == publish_head) {
+        return false;
+    }
+    *external_value = publish_queue[tail];
+    publish_tail = (uint8_t)((tail + 1) & (ADC_PUBLISH_QUEUE - 1));
+    return true;
+}
+
+/* Last published value, without consuming it (telemetry) */
+uint16_t adc_last_value(){
+    return publish_value;
+}
+
+void adc_set_publish_mode(adc_publish_mode_t mode) {
+    ADC12IE &= ~ADC12IE0;           /* detector state is owned by the ISR */
+    cusum_reset();
+    change_dir = 0;
+    publish_mode = mode;
+    ADC12IE |= ADC12IE0;
+}
+
+/* CUSUM k/h changed: state built with the old values is stale, restart learning */
+static void restart_detector() {
+    adc_set_publish_mode(publish_mode);
+}
+
+REGISTER_PARAM("ADC_THR", PARAM_U16, 1, 4095, change_threshold, 0);
+REGISTER_PARAM("CUSUM_H", PARAM_U16, 1, CUSUM_H_MAX, cusum_limit, restart_detector);
+REGISTER_PARAM("CUSUM_K", PARAM_U16, 0, 4095, cusum_slack, restart_detector);
+
+adc_publish_mode_t adc_publish_mode() {
+    return publish_mode;
+}
+
+/* Queue every decimate-th sample for streaming; 0 stops and clears */
+void adc_stream_enable(uint16_t decimate) {
+    ADC12IE &= ~ADC12IE0;
+    stream_decimate = decimate;
+    stream_phase = 0;
+    stream_head = 0;
+    stream_tail = 0;
+    stream_drops = 0;
+    ADC12IE |= ADC12IE0;
+}
+
+uint16_t adc_stream_decimation() {
+    return stream_decimate;
+}
+
+uint16_t adc_stream_drops() {
+    return stream_drops;
+}
+
+/* Oldest queued sample; single consumer (main), no locking needed */
+bool adc_stream_pop(uint16_t *stamp, uint16_t *value) {
+    uint8_t tail = stream_tail;
+    if (tail == stream_head) {
+        return false;
+    }
+    *stamp = stream_queue[tail].stamp;
+    *value = stream_queue[tail].value;
+    stream_tail = (uint8_t)((tail + 1) & (ADC_STREAM_QUEUE - 1));
+    return true;
+}
+
+/* CUSUM mode: return true once per detected shift with its direction */
+bool consume_adc_change_event(int8_t *dir) {
+    if (change_dir) {
+        *dir = change_dir;
+        change_dir = 0;
+        return true;
     }
     return false;
 }
 
-/* ADC12 MEM0 ISR: publish sample if change > threshold, wake from LPM0 */
+/*
+ * ISR side of the publish queue. Full: overwrite the newest entry, which
+ * main is not reading (it only reads the tail, and full means more than
+ * one entry is queued).
+ */
+static void publish(uint16_t raw) {
+    publish_value = raw;
+    uint8_t head = publish_head;
+    uint8_t next = (uint8_t)((head + 1) & (ADC_PUBLISH_QUEUE - 1));
+    if (next == publish_tail) {
+        publish_queue[(head - 1) & (ADC_PUBLISH_QUEUE - 1)] = raw;
+    } else {
+        publish_queue[head] = raw;
+        publish_head = next;
+    }
+}
+
+/*
+ * ADC12 MEM0 ISR: publish sample on threshold crossing or CUSUM shift.
+ *
+ * Reading ADC12MEM0 acknowledges the source; the analyzer/CUSUM work
+ * after it runs nested (GIE set, MEM0 masked) so the tick is never held
+ * off by it. If a waking ISR (tick, RTC alarm) preempted us, its wake
+ * cleared LPM bits in our frame rather than main's, so the wake is
+ * repeated on our exit.
+ */
 
 #pragma vector=ADC12_VECTOR
 __interrupt void ADC12_interrupt(void) {
     if (ADC12IV == ADC12IV_ADC12IFG0) { 
         static uint16_t last_published = 0;
         uint16_t raw  = ADC12MEM0; 
-        uint16_t diff = (raw > last_published) ? (raw - last_published) : (last_published - raw);
-        if(diff >  ADC_CHANGE_THRESHHOLD ) {
-            last_published = raw; /* update reference point */
-            publish_value = raw;  /* value to be consumed by main */
-            published = false; /* mark as needing publication */
-                     
+        bool nested = nest_begin(&ADC12IE, ADC12IE0);
+        RECORD_INPUT(REC_SRC_ADC, raw);
+        analyzer_sample(raw);
+        if (stream_decimate && ++stream_phase >= stream_decimate) {
+            stream_phase = 0;
+            uint8_t next = (uint8_t)((stream_head + 1) & (ADC_STREAM_QUEUE - 1));
+            if (next == stream_tail) {
+                ++stream_drops;
+            } else {
+                stream_queue[stream_head].stamp = timestamp_now();
+                stream_queue[stream_head].value = raw;
+                stream_head = next;
+            }
+        }
+        if (publish_mode == ADC_PUBLISH_CUSUM) {
+            int8_t dir = cusum_update(raw);
+            if (dir) {
+                change_dir = dir;     /* level shift: publish the new level */
+                publish(raw);
+            }
+        } else {
+            uint16_t diff = (raw > last_published) ? (raw - last_published) : (last_published - raw);
+            if(diff >  change_threshold ) {
+                last_published = raw; /* update reference point */
+                publish(raw);         /* value to be consumed by main */
+                         
+            }
+            /* Else: ignore small jitter; do not update or wake main. */
+        }
+        if (nest_end(&ADC12IE, ADC12IE0, nested)) {
+            __bic_SR_register_on_exit(LPM3_bits);
         }
-        /* Else: ignore small jitter; do not update or wake main. */
     }
     /* No other ADC12IV cases are expected: only MEM0 interrupt is enabled. */
 
@@ -2,7 +2,26 @@
 #define ADC_H
 
 #include <stdbool.h> 
+#include <stdint.h>
+typedef enum {
+    ADC_PUBLISH_THRESHOLD,
+    ADC_PUBLISH_CUSUM
+} adc_publish_mode_t;
+
 void adc_init();
+void adc_start();
+void adc_stop();
+void adc_clock_changed();
+void adc_set_slow(bool slow);
+bool adc_needs_smclk();
 bool poll_adc_value(uint16_t *external_value);
+uint16_t adc_last_value();
+void adc_set_publish_mode(adc_publish_mode_t mode);
+adc_publish_mode_t adc_publish_mode();
+bool consume_adc_change_event(int8_t *dir);
+void adc_stream_enable(uint16_t decimate);
+uint16_t adc_stream_decimation();
+uint16_t adc_stream_drops();
+bool adc_stream_pop(uint16_t *stamp, uint16_t *value);
 
 #endif
@@ -0,0 +1,167 @@
+/**
+ * @file analyzer.c
+ * @brief Streaming AC analysis of A0: frequency, Vpp and RMS per window.
+ *
+ * analyzer_sample() runs in the ADC ISR for every sample:
+ * - DC removal: first-order low-pass DC estimate in 32-bit Q16, so the
+ *   shifted update has no deadband or bias to speak of; ac = raw - dc
+ * - rising zero crossings with +/-HYST counts of hysteresis, time-stamped
+ *   with the ~1 us timestamp (elapsed time accumulated per sample)
+ * - envelope: min/max of ac over the window
+ * - sum of (ac/2)^2 on the MPY32 MAC; RESHI:RESLO is reloaded from our
+ *   accumulator first, so other multiplier users in between are harmless
+ *
+ * Every ANALYZER_WINDOW samples (~72 ms at the default sample rate) the
+ * raw sums replace the previous finished window; consume_analyzer_result()
+ * turns the latest one into frequency/Vpp/RMS outside the ISR (one
+ * division and one integer square root per read).
+ */
+
+#include <msp430.h>
+#include "analyzer.h"
+#include "timestamp.h"
+
+#define ANALYZER_WINDOW 512     /* 512 x 2048^2 still fits the 32-bit MAC */
+#define DC_SHIFT 8              /* DC time constant: 256 samples */
+#define HYST 16                 /* raw counts */
+#define AVCC_MV 3300UL
+#define ADC_FULL_SCALE 4095UL
+
+typedef struct {
+    uint32_t sumsq;             /* sum of (ac/2)^2 */
+    uint32_t first_cross_us;
+    uint32_t last_cross_us;
+    uint16_t crossings;
+    int16_t ac_max;
+    int16_t ac_min;
+    uint16_t dc;
+} window_t;
+
+static volatile bool enabled = false;
+static int32_t dc_q16 = 0;
+static bool armed = false;
+static uint16_t n = 0;
+static uint32_t elapsed_us = 0;
+static uint16_t last_stamp = 0;
+static window_t acc;
+static window_t done;
+static volatile bool done_ready = false;
+
+static void window_reset() {
+    acc.sumsq = 0;
+    acc.crossings = 0;
+    acc.ac_max = INT16_MIN;
+    acc.ac_min = INT16_MAX;
+    n = 0;
+    elapsed_us = 0;
+}
+
+void analyzer_enable(bool on) {
+    if (on && !enabled) {
+        window_reset();
+        last_stamp = timestamp_now();
+        dc_q16 = 2048L << 16;       /* mid-scale start, settles in a few windows */
+        armed = false;
+        done_ready = false;
+    }
+    enabled = on;
+}
+
+bool analyzer_enabled() {
+    return enabled;
+}
+
+/* Per-sample update; called from the ADC ISR */
+void analyzer_sample(uint16_t raw) {
+    if (!enabled) {
+        return;
+    }
+
+    uint16_t now = timestamp_now();
+    elapsed_us += (uint16_t)(now - last_stamp);
+    last_stamp = now;
+
+    dc_q16 += (((int32_t)raw << 16) - dc_q16) >> DC_SHIFT;
+    int16_t ac = (int16_t)raw - (int16_t)((dc_q16 + 0x8000) >> 16);
+
+    if (ac < -HYST) {
+        armed = true;
+    } else if (armed && ac > HYST) {
+        armed = false;
+        if (acc.crossings == 0) {
+            acc.first_cross_us = elapsed_us;
+        }
+        acc.last_cross_us = elapsed_us;
+        ++acc.crossings;
+    }
+
+    if (ac > acc.ac_max) {
+        acc.ac_max = ac;
+    }
+    if (ac < acc.ac_min) {
+        acc.ac_min = ac;
+    }
+
+    /* The ADC ISR runs this nested: keep a preempting ISR off the MPY32 */
+    int16_t half = ac >> 1;
+    uint16_t state = __get_interrupt_state();
+    __disable_interrupt();
+    RESLO = (uint16_t)acc.sumsq;
+    RESHI = (uint16_t)(acc.sumsq >> 16);
+    MACS = half;
+    OP2 = half;
+    acc.sumsq = ((uint32_t)RESHI << 16) | RESLO;
+    __set_interrupt_state(state);
+
+    if (++n == ANALYZER_WINDOW) {
+        acc.dc = (uint16_t)((dc_q16 + 0x8000) >> 16);
+        done = acc;                 /* latest window wins */
+        done_ready = true;
+        window_reset();
+    }
+}
+
+static uint16_t isqrt32(uint32_t v) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint16_t)root;
+}
+
+static uint16_t counts_to_mv(uint32_t counts) {
+    return (uint16_t)((counts * AVCC_MV + ADC_FULL_SCALE / 2) / ADC_FULL_SCALE);
+}
+
+/* Convert the latest finished window; false until one new window is done */
+bool consume_analyzer_result(analyzer_result_t *r) {
+    if (!done_ready) {
+        return false;
+    }
+    uint16_t ie = ADC12IE & ADC12IE0;   /* the ISR may be writing `done` */
+    ADC12IE &= ~ADC12IE0;
+    window_t w = done;
+    done_ready = false;
+    ADC12IE |= ie;
+
+    /* (crossings - 1) x 1e7 fits 32 bits up to ~430 crossings per window,
+     * well above the ~250 possible at the Nyquist rate */
+    uint32_t span = w.last_cross_us - w.first_cross_us;
+    r->freq_dhz = (w.crossings >= 2 && span > 0)
+        ? (uint16_t)((w.crossings - 1) * 10000000UL / span)
+        : 0;
+    r->vpp_mv = counts_to_mv((uint32_t)(w.ac_max - w.ac_min));
+    r->rms_mv = counts_to_mv(2UL * isqrt32(w.sumsq / ANALYZER_WINDOW));
+    r->dc_mv = counts_to_mv(w.dc);
+    return true;
+}
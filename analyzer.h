@@ -0,0 +1,19 @@
+#ifndef ANALYZER_H
+#define ANALYZER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint16_t freq_dhz;      /* frequency, 0.1 Hz units; 0 if < 2 crossings */
+    uint16_t vpp_mv;        /* peak-to-peak of the AC component */
+    uint16_t rms_mv;        /* RMS of the AC component */
+    uint16_t dc_mv;         /* DC level removed by the filter */
+} analyzer_result_t;
+
+void analyzer_enable(bool on);
+bool analyzer_enabled();
+void analyzer_sample(uint16_t raw);
+bool consume_analyzer_result(analyzer_result_t *result);
+
+#endif
@@ -0,0 +1,181 @@
+/**
+ * @file baud.c
+ * @brief Console baud-rate negotiation with a verified switch and fallback.
+ *
+ * The host drives, the device answers:
+ *
+ *   host  BAUD <rate>            at the current rate
+ *   dev   ACK <rate>             at the current rate, then switches
+ *   dev   BAUD TEST <pattern>    at the new rate, every 100 ms
+ *   host  BAUD CHECK <pattern>   once it has switched and read a TEST line
+ *   dev   BAUD <rate> OK         committed
+ *
+ * A wrong pattern, or no CHECK within 1 s of the switch, puts the device
+ * back on the last verified rate and prints "BAUD <rate> FAIL" there; a
+ * host that sees no OK goes back too. The pattern mixes 'U' (0x55), '*'
+ * (0x2A), '5' (0x35) and 'Z' (0x5A) so every data bit toggles and a
+ * sampling error shows up as a different character rather than a dropped
+ * one.
+ *
+ * Two states on the HSM (hsm.c): STEADY on a verified rate and VERIFY on
+ * a trial rate. Entering VERIFY makes the switch; its transitions back to
+ * STEADY either commit the trial rate or restore the verified one.
+ *
+ * Rates above the 115200 default hold a clock boost: at ~1 MHz SMCLK the
+ * divider would be 4.5 for 230400 and too coarse beyond that, while at
+ * 16 MHz even 921600 has N = 17.4 (UCBRS modulation, <2% bit error).
+ */
+
+#include "baud.h"
+#include <string.h>
+#include "hsm.h"
+#include "clock.h"
+#include "scheduler.h"
+#include "uart.h"
+
+#define BAUD_DEFAULT 115200UL
+#define BAUD_VERIFY_POLLS 10            /* task runs (100 ms) before fallback */
+
+static const uint32_t rates[] = { 115200UL, 230400UL, 460800UL, 921600UL };
+
+#define NUM_RATES (sizeof(rates) / sizeof(rates[0]))
+
+enum { ST_LINK, ST_STEADY, ST_VERIFY, NUM_STATES };
+enum { EV_PROPOSE, EV_CHECK_OK, EV_CHECK_BAD, EV_TIMEOUT, NUM_EVENTS };
+
+static uint32_t verified = BAUD_DEFAULT;
+static uint32_t proposed = BAUD_DEFAULT;
+static uint8_t polls = 0;
+static bool boosted = false;
+static uint16_t switches = 0;
+static uint16_t fallbacks = 0;
+
+/* Switch the USCI to rate; the boost is taken before a rise above the default */
+static void apply_rate(uint32_t rate) {
+    if (rate > BAUD_DEFAULT && !boosted) {
+        clock_boost_acquire();
+        boosted = true;
+    }
+    uart_set_baud(rate);
+    if (rate <= BAUD_DEFAULT && boosted) {
+        clock_boost_release();
+        boosted = false;
+    }
+}
+
+static void send_test() {
+    uart_puts("\nBAUD TEST " BAUD_PATTERN "\n");
+}
+
+/* Entering VERIFY: acknowledge at the old rate, then move */
+static void enter_verify(hsm_t *m) {
+    uart_puts("\nACK ");
+    uart_put_uint32(proposed);
+    uart_putc('\n');
+    apply_rate(proposed);
+    polls = 0;
+    if (switches < UINT16_MAX) {
+        ++switches;
+    }
+    send_test();
+}
+
+static void commit(hsm_t *m) {
+    verified = proposed;
+    uart_puts("\nBAUD ");
+    uart_put_uint32(verified);
+    uart_puts(" OK\n");
+}
+
+static void fall_back(hsm_t *m) {
+    apply_rate(verified);
+    if (fallbacks < UINT16_MAX) {
+        ++fallbacks;
+    }
+    uart_puts("\nBAUD ");
+    uart_put_uint32(verified);
+    uart_puts(" FAIL\n");
+}
+
+static const hsm_state_t baud_states[NUM_STATES] = {
+    [ST_LINK]   = { HSM_NONE, 0, 0 },
+    [ST_STEADY] = { ST_LINK, 0, 0 },
+    [ST_VERIFY] = { ST_LINK, enter_verify, 0 },
+};
+
+#define NO_TRANSITION { HSM_NONE, 0, 0 }
+#define GO(state, action) { (state), 0, (action) }
+
+static const hsm_transition_t baud_transitions[NUM_STATES][NUM_EVENTS] = {
+    [ST_LINK]   = { NO_TRANSITION, NO_TRANSITION, NO_TRANSITION, NO_TRANSITION },
+    [ST_STEADY] = { [EV_PROPOSE] = GO(ST_VERIFY, 0), [EV_CHECK_OK] = NO_TRANSITION,
+                    [EV_CHECK_BAD] = NO_TRANSITION, [EV_TIMEOUT] = NO_TRANSITION },
+    [ST_VERIFY] = { [EV_PROPOSE] = NO_TRANSITION, [EV_CHECK_OK] = GO(ST_STEADY, commit),
+                    [EV_CHECK_BAD] = GO(ST_STEADY, fall_back), [EV_TIMEOUT] = GO(ST_STEADY, fall_back) },
+};
+
+static const hsm_def_t baud_def = {
+    .states = baud_states,
+    .transitions = &baud_transitions[0][0],
+    .num_states = NUM_STATES,
+    .num_events = NUM_EVENTS,
+    .initial = ST_STEADY,
+};
+
+/* STEADY has no entry action, so the machine can start statically */
+static hsm_t baud_hsm = { &baud_def, ST_STEADY };
+
+bool baud_supported(uint32_t rate) {
+    for (uint8_t i = 0; i < NUM_RATES; ++i) {
+        if (rates[i] == rate) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Start a trial at rate; false while another trial is running */
+bool baud_propose(uint32_t rate) {
+    if (!baud_supported(rate) || baud_hsm.state != ST_STEADY) {
+        return false;
+    }
+    proposed = rate;
+    return hsm_dispatch(&baud_hsm, EV_PROPOSE);
+}
+
+/* Host echo of the test line; false when no trial is running */
+bool baud_check(const char *pattern) {
+    uint8_t ev = strcmp(pattern, BAUD_PATTERN) == 0 ? EV_CHECK_OK : EV_CHECK_BAD;
+    return hsm_dispatch(&baud_hsm, ev);
+}
+
+/* Repeat the test line during a trial and fall back when it runs out */
+void poll_baud(uint16_t g_ticks) {
+    if (baud_hsm.state != ST_VERIFY) {
+        return;
+    }
+    if (++polls >= BAUD_VERIFY_POLLS) {
+        hsm_dispatch(&baud_hsm, EV_TIMEOUT);
+        return;
+    }
+    send_test();
+}
+
+static task_t task_baud = {
+    .name = "baud",
+    .fn = poll_baud,
+    .period_ms = 100,
+    .next_run = 0
+};
+REGISTER_TASK("08_BAUD", task_baud);
+
+void baud_report() {
+    uart_puts("\nBAUD ");
+    uart_put_uint32(uart_baud());
+    uart_puts(baud_hsm.state == ST_VERIFY ? " TRIAL" : " VERIFIED");
+    uart_puts(" SWITCHES ");
+    uart_put_uint16(switches);
+    uart_puts(" FALLBACKS ");
+    uart_put_uint16(fallbacks);
+    uart_putc('\n');
+}
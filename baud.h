@@ -0,0 +1,15 @@
+#ifndef BAUD_H
+#define BAUD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BAUD_PATTERN "U*5ZU*5Z"
+
+bool baud_supported(uint32_t rate);
+bool baud_propose(uint32_t rate);
+bool baud_check(const char *pattern);
+void poll_baud(uint16_t);
+void baud_report();
+
+#endif
@@ -1,32 +1,135 @@
+/**
+ * @file button.c
+ * @brief P1.1 button: sampled debounce + short/long press state machine.
+ *
+ * The press logic is a table-driven HSM (hsm.c):
+ *
+ *   RELEASED --DOWN--> PRESSED                 (entry: start hold count)
+ *   DOWN { PRESSED, HELD }
+ *     PRESSED --DOWN [held long]--> HELD       (long press event)
+ *     PRESSED --UP--> RELEASED                 (short press event)
+ *     DOWN    --DOWN--> internal               (accumulate held ms)
+ *     DOWN    --UP--> RELEASED                 (release after HELD)
+ *
+ * One event per poll: DOWN while the debounced input is pressed, UP
+ * otherwise. Debounce and hold times are in ms and converted with the
+ * current tick period, so TICK <ms> keeps them unchanged. Building with BUTTON_FSM_BENCH also compiles the previous
+ * hand-written switch version and button_fsm_bench() to compare them.
+ */
+
 #include "button.h"
 #include <msp430.h>
 #include <stdint.h>
 #include "uart.h"
+#include "hsm.h"
+#include "record.h"
+#include "ticker.h"
+#include "param.h"
 
-#define NUMBER_OF_DEBOUNCE_SAMPLES 5
-#define HELD_TICKS 400
+static volatile uint8_t debounce_ms = 25;
+static volatile uint16_t hold_ms = 2000;
+
+REGISTER_PARAM("BTN_DEB", PARAM_U8, 1, 200, debounce_ms, 0);
+REGISTER_PARAM("BTN_HELD", PARAM_U16, 100, 60000, hold_ms, 0);
 
 
 //debounce variables
 static uint8_t last_button_raw_state;
 static uint8_t button_raw_stable_count = 0;
 
-//State variables 
+//State machine
 
-typedef enum {
-    RELEASED,
-    PRESSED,
-    HELD
-} ButtonState;
+enum {
+    BTN_RELEASED,
+    BTN_DOWN,           /* superstate of PRESSED and HELD */
+    BTN_PRESSED,
+    BTN_HELD,
+    BTN_NUM_STATES
+};
 
-static int held_consecutive_count = 0; 
-static ButtonState button_state = RELEASED; 
+enum {
+    BTN_EV_DOWN,        /* sampled pressed */
+    BTN_EV_UP,          /* sampled released */
+    BTN_NUM_EVENTS
+};
+
+static hsm_t button_hsm;
+static uint16_t now_ticks;          /* g_ticks of the event being dispatched */
+static uint16_t l_ticks;
+static uint16_t held_ms = 0;
 static bool long_press_event = false;
 static bool short_press_event = false;
+static uint8_t long_presses = 0;     /* wrapping counts for telemetry */
+static uint8_t short_presses = 0;
 
 //shared 
 static bool debounce_pressed = false; // true when we the debouncer has determined that a debounce press has occured
 
+static void start_hold(hsm_t *m) {
+    l_ticks = now_ticks;
+    held_ms = ticker_period_ms();
+}
+
+static void count_hold(hsm_t *m) {
+    uint32_t ms = held_ms + (uint32_t)(uint16_t)(now_ticks - l_ticks) * ticker_period_ms();
+    held_ms = (ms > UINT16_MAX) ? UINT16_MAX : (uint16_t)ms;
+    l_ticks = now_ticks;
+}
+
+static bool held_long(const hsm_t *m) {
+    return held_ms >= hold_ms;
+}
+
+static void long_press(hsm_t *m) {
+    long_press_event = true;
+    ++long_presses;
+}
+
+static void short_press(hsm_t *m) {
+    short_press_event = true;
+    ++short_presses;
+}
+
+static void clear_hold(hsm_t *m) {
+    held_ms = 0;
+}
+
+static const hsm_state_t button_states[BTN_NUM_STATES] = {
+    [BTN_RELEASED] = { HSM_NONE,  0,          0          },
+    [BTN_DOWN]     = { HSM_NONE,  0,          clear_hold },
+    [BTN_PRESSED]  = { BTN_DOWN,  start_hold, 0          },
+    [BTN_HELD]     = { BTN_DOWN,  0,          0          },
+};
+
+#define NO_TRANSITION { HSM_NONE, 0, 0 }
+
+static const hsm_transition_t button_transitions[BTN_NUM_STATES][BTN_NUM_EVENTS] = {
+    [BTN_RELEASED] = {
+        [BTN_EV_DOWN] = { BTN_PRESSED, 0, 0 },
+        [BTN_EV_UP]   = NO_TRANSITION,
+    },
+    [BTN_DOWN] = {
+        [BTN_EV_DOWN] = { HSM_INTERNAL, 0, count_hold },
+        [BTN_EV_UP]   = { BTN_RELEASED, 0, 0 },
+    },
+    [BTN_PRESSED] = {
+        [BTN_EV_DOWN] = { BTN_HELD, held_long, long_press },
+        [BTN_EV_UP]   = { BTN_RELEASED, 0, short_press },
+    },
+    [BTN_HELD] = {
+        [BTN_EV_DOWN] = NO_TRANSITION,
+        [BTN_EV_UP]   = NO_TRANSITION,
+    },
+};
+
+static const hsm_def_t button_def = {
+    .states = button_states,
+    .transitions = &button_transitions[0][0],
+    .num_states = BTN_NUM_STATES,
+    .num_events = BTN_NUM_EVENTS,
+    .initial = BTN_RELEASED,
+};
+
 
 
 void button_init() {
@@ -34,6 +137,7 @@ void button_init() {
     P1REN |= BIT1;      // set P1.1 resistor to be on activated
     P1OUT |= BIT1;      // set p1.1 to use pull up resistor 
     last_button_raw_state = P1IN & BIT1;
+    hsm_init(&button_hsm, &button_def);
 
 }
 
@@ -43,41 +147,92 @@ void button_init() {
 void button_debounce() {
     
     uint8_t debounce_sample = P1IN & BIT1;          // BIT0 = pressed, BIT1 = released
+    uint8_t samples = (uint8_t)(debounce_ms / ticker_period_ms());   // one per tick
+    if (samples == 0) {
+        samples = 1;
+    }
 
     if (debounce_sample == last_button_raw_state ) {
-        if (button_raw_stable_count < NUMBER_OF_DEBOUNCE_SAMPLES){
+        if (button_raw_stable_count < samples){
         button_raw_stable_count += 1; // need to trim to max
         } 
         
     } else {
         button_raw_stable_count = 1; 
         last_button_raw_state = debounce_sample;
+        RECORD_INPUT(REC_SRC_BUTTON, debounce_sample ? 1 : 0);
     }
 
-    if (button_raw_stable_count >= NUMBER_OF_DEBOUNCE_SAMPLES) {
+    if (button_raw_stable_count >= samples) {
         debounce_pressed = (last_button_raw_state == 0); // low voltage when pressed
     }
     
 } 
 
 void update_button_state(uint16_t g_ticks) {
+    now_ticks = g_ticks;
+    hsm_dispatch(&button_hsm, debounce_pressed ? BTN_EV_DOWN : BTN_EV_UP);
+}
+
+bool consume_short_press_event() {
+    if (short_press_event) {
+        short_press_event = false;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+bool consume_long_press_event() {
+      if (long_press_event) {
+        long_press_event = false;
+        return true;
+    } else {
+        return false;
+    }    
+}
+
+/* Presses so far, long count in the high byte; both wrap */
+uint16_t button_press_counts() {
+    return (uint16_t)(((uint16_t)long_presses << 8) | short_presses);
+}
+
+#ifdef BUTTON_FSM_BENCH
+#include "timestamp.h"
+
+#define HELD_TICKS 400
+
+/* The hand-written switch implementation the HSM replaced, kept verbatim
+ * (own state) as the baseline for button_fsm_bench(). */
+typedef enum {
+    RELEASED,
+    PRESSED,
+    HELD
+} ButtonState;
+
+static ButtonState switch_state = RELEASED;
+static int switch_held_count = 0;
+static bool switch_long_event = false;
+static bool switch_short_event = false;
+
+static void update_button_state_switch(bool pressed, uint16_t g_ticks) {
     static uint16_t l_ticks;
-    if (debounce_pressed) { //pressed
-        switch (button_state){
+    if (pressed) { //pressed
+        switch (switch_state){
             case RELEASED:              //RELEASED ==> PRESSED //when its pressed, start counting ticks 
-                button_state = PRESSED;
+                switch_state = PRESSED;
                 l_ticks = g_ticks;
-                held_consecutive_count = 1;
+                switch_held_count = 1;
                 break;
             case PRESSED:
-                if(held_consecutive_count < HELD_TICKS) {    //PRESSED==> PRESSED
+                if(switch_held_count < HELD_TICKS) {    //PRESSED==> PRESSED
                     uint16_t passed_ticks = g_ticks - l_ticks;
-                    button_state = PRESSED;
+                    switch_state = PRESSED;
                     l_ticks = g_ticks;
-                    held_consecutive_count += passed_ticks;
+                    switch_held_count += passed_ticks;
                 } else {                          //PRESSED ==> HELD
-                    long_press_event = true;
-                    button_state = HELD;
+                    switch_long_event = true;
+                    switch_state = HELD;
                 }    
                 break;
             case HELD:      //HELD ==> HELD
@@ -86,37 +241,65 @@ void update_button_state(uint16_t g_ticks) {
 
     } 
     else { //released
-        switch (button_state){
+        switch (switch_state){
         case RELEASED:                  //RELEASED ==> RELEASED 
             break;
         case PRESSED:
-            button_state = RELEASED;    //RELEASED ==> RELEASED
-            held_consecutive_count = 0;
-            short_press_event = true;
+            switch_state = RELEASED;    //RELEASED ==> RELEASED
+            switch_held_count = 0;
+            switch_short_event = true;
             break;
         case HELD:                      //HELD ==> RELEASED
-            button_state = RELEASED;
-            held_consecutive_count= 0;
+            switch_state = RELEASED;
+            switch_held_count= 0;
             break;
         }
     }
-    
 }
 
-bool consume_short_press_event() {
-    if (short_press_event) {
-        short_press_event = false;
-        return true;
-    } else {
-        return false;
-    }
+/* Synthetic input: long hold, short gap, short press, short gap, repeat */
+static bool bench_pressed(uint16_t i) {
+    uint16_t phase = i % 460;
+    return phase < 420 || (phase >= 430 && phase < 450);
 }
 
-bool consume_long_press_event() {
-      if (long_press_event) {
-        long_press_event = false;
-        return true;
-    } else {
-        return false;
-    }    
+/*
+ * Drive both implementations with the same n-step input and accumulate
+ * their time (timestamp counts). The HSM run uses the live button state,
+ * which is restored afterwards; events it raised are discarded.
+ */
+void button_fsm_bench(uint16_t n, uint32_t *hsm_time, uint32_t *switch_time) {
+    hsm_t saved = button_hsm;
+    uint16_t saved_l_ticks = l_ticks;
+    uint16_t saved_held = held_ms;
+    bool saved_long = long_press_event;
+    bool saved_short = short_press_event;
+    uint8_t saved_longs = long_presses;
+    uint8_t saved_shorts = short_presses;
+
+    hsm_init(&button_hsm, &button_def);
+    *hsm_time = 0;
+    *switch_time = 0;
+    for (uint16_t i = 0; i < n; ++i) {
+        bool pressed = bench_pressed(i);
+
+        uint16_t t0 = timestamp_now();
+        now_ticks = i;
+        hsm_dispatch(&button_hsm, pressed ? BTN_EV_DOWN : BTN_EV_UP);
+        uint16_t t1 = timestamp_now();
+        update_button_state_switch(pressed, i);
+        uint16_t t2 = timestamp_now();
+
+        *hsm_time += (uint16_t)(t1 - t0);
+        *switch_time += (uint16_t)(t2 - t1);
+    }
+
+    button_hsm = saved;
+    l_ticks = saved_l_ticks;
+    held_ms = saved_held;
+    long_press_event = saved_long;
+    short_press_event = saved_short;
+    long_presses = saved_longs;
+    short_presses = saved_shorts;
 }
+#endif
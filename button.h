@@ -2,15 +2,22 @@
 #define BUTTON_H
 
 #include "stdbool.h"
+#include <stdint.h>
 
 void button_init();
 
 void button_debounce();
 
-void update_button_state();
+void update_button_state(uint16_t);
 
 bool consume_short_press_event();
 
 bool consume_long_press_event();
 
+uint16_t button_press_counts();
+
+#ifdef BUTTON_FSM_BENCH
+void button_fsm_bench(uint16_t n, uint32_t *hsm_time, uint32_t *switch_time);
+#endif
+
 #endif
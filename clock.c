@@ -0,0 +1,172 @@
+/**
+ * @file clock.c
+ * @brief Reference-counted MCLK/SMCLK boost (PMM core voltage + DCO/FLL).
+ *
+ * Two operating points, both with MCLK = SMCLK = DCOCLKDIV from the FLL:
+ * - slow: reset default, 32 x 32768 Hz (~1.05 MHz) at PMMCOREV_0
+ * - fast: 488 x 32768 Hz (~16 MHz) at PMMCOREV_2
+ *
+ * Callers bracket heavy work with clock_boost_acquire()/_release(); the
+ * first acquire raises Vcore one level at a time and then the DCO, the
+ * last release lowers the DCO and then Vcore. After each switch the
+ * SMCLK-based peripherals (UART baud, timestamp, ADC) are retuned so
+ * their rates are unchanged. Main context only: not for use from ISRs.
+ * A switch blocks until the FLL locks: typically a few ms, at most ~31 ms.
+ *
+ * Ticker and PWM run from ACLK and are unaffected by a switch.
+ */
+
+#include <msp430.h>
+#include "clock.h"
+#include "uart.h"
+#include "adc.h"
+#include "timestamp.h"
+
+#define FLL_REF_HZ 32768UL
+
+#define SLOW_FLLN 31            /* DCOCLKDIV = (31 + 1) * 32768 */
+#define SLOW_DCORSEL DCORSEL_2
+#define SLOW_VCORE 0
+
+#define FAST_FLLN 487           /* DCOCLKDIV = (487 + 1) * 32768 */
+#define FAST_DCORSEL DCORSEL_6
+#define FAST_VCORE 2
+
+#define CLOCK_HZ(flln) (((flln) + 1UL) * FLL_REF_HZ)
+
+/*
+ * The FLL moves DCO.MOD (UCSCTL0 bits 12:3) by one MOD step per reference
+ * period while it ramps, so samples 32 periods apart differ by a whole DCO
+ * tap until it locks and then only dither. Worst-case lock is 32 x 32
+ * periods (~31 ms, User's Guide UCS); typical is a few ms.
+ */
+#define FLL_SAMPLE_CYCLES(flln) (32UL * ((flln) + 1UL))
+#define FLL_MAX_SAMPLES 36              /* > 32 samples: worst-case lock */
+#define FLL_LOCKED_STEPS 8              /* MOD steps of dither when locked */
+
+static uint8_t boost_refs = 0;
+static uint32_t mclk_hz = CLOCK_HZ(SLOW_FLLN);
+
+/* Raise Vcore by one level (sequence per User's Guide, PMM) */
+static void vcore_up(uint8_t level) {
+    PMMCTL0_H = PMMPW_H;                         /* unlock PMM */
+    SVSMHCTL = SVSHE | (SVSHRVL0 * level) | SVMHE | (SVSMHRRL0 * level);
+    SVSMLCTL = SVSLE | SVMLE | (SVSMLRRL0 * level);
+    while ((PMMIFG & SVSMLDLYIFG) == 0);         /* SVM settled */
+    PMMIFG &= ~(SVMLVLRIFG | SVMLIFG);
+    PMMCTL0_L = PMMCOREV0 * level;
+    if (PMMIFG & SVMLIFG) {
+        while ((PMMIFG & SVMLVLRIFG) == 0);      /* new level reached */
+    }
+    SVSMLCTL = SVSLE | (SVSLRVL0 * level) | SVMLE | (SVSMLRRL0 * level);
+    PMMCTL0_H = 0x00;                            /* lock PMM */
+}
+
+/* Lower Vcore by one level; MCLK must already be within the new level */
+static void vcore_down(uint8_t level) {
+    PMMCTL0_H = PMMPW_H;
+    SVSMLCTL = SVSLE | (SVSLRVL0 * level) | SVMLE | (SVSMLRRL0 * level);
+    while ((PMMIFG & SVSMLDLYIFG) == 0);
+    PMMIFG &= ~(SVMLVLRIFG | SVMLIFG);
+    PMMCTL0_L = PMMCOREV0 * level;
+    PMMCTL0_H = 0x00;
+}
+
+/*
+ * Wait until the DCO is out of the fault taps and the FLL has stopped
+ * ramping, bounded by the worst-case lock time. Only DCOFFG is checked:
+ * XT1/XT2 faults (no crystal, crystal still starting) do not concern the
+ * DCO and are handled by clock_xt1_poll().
+ */
+static void fll_wait(uint16_t flln) {
+    uint16_t last = UCSCTL0 >> 3;
+    for (uint8_t i = 0; i < FLL_MAX_SAMPLES; ++i) {
+        if (flln == FAST_FLLN) {
+            __delay_cycles(FLL_SAMPLE_CYCLES(FAST_FLLN));
+        } else {
+            __delay_cycles(FLL_SAMPLE_CYCLES(SLOW_FLLN));
+        }
+        UCSCTL7 &= ~DCOFFG;
+        uint16_t now = UCSCTL0 >> 3;
+        int16_t step = (int16_t)(now - last);
+        last = now;
+        if (!(UCSCTL7 & DCOFFG) && step < FLL_LOCKED_STEPS && step > -FLL_LOCKED_STEPS) {
+            return;
+        }
+    }
+}
+
+/* Reprogram the FLL and wait for the DCO to settle */
+static void dco_set(uint16_t dcorsel, uint16_t flln) {
+    __bis_SR_register(SCG0);          /* disable FLL control loop */
+    UCSCTL0 = 0x0000;                 /* lowest DCOx/MODx, FLL ramps up */
+    UCSCTL1 = dcorsel;
+    UCSCTL2 = FLLD_1 | flln;          /* DCOCLK = 2 x DCOCLKDIV */
+    __bic_SR_register(SCG0);          /* re-enable FLL control loop */
+
+    fll_wait(flln);
+    mclk_hz = CLOCK_HZ(flln);
+}
+
+/* Retune everything that derives a rate from SMCLK */
+static void notify_clock_changed() {
+    timestamp_clock_changed();
+    uart_clock_changed();
+    adc_clock_changed();
+}
+
+void clock_boost_acquire() {
+    if (boost_refs++ > 0) {
+        return;
+    }
+    uart_tx_flush();
+    for (uint8_t level = SLOW_VCORE + 1; level <= FAST_VCORE; ++level) {
+        vcore_up(level);
+    }
+    dco_set(FAST_DCORSEL, FAST_FLLN);
+    notify_clock_changed();
+}
+
+void clock_boost_release() {
+    if (boost_refs == 0 || --boost_refs > 0) {
+        return;
+    }
+    uart_tx_flush();
+    dco_set(SLOW_DCORSEL, SLOW_FLLN);
+    notify_clock_changed();
+    for (uint8_t level = FAST_VCORE; level > SLOW_VCORE; --level) {
+        vcore_down(level - 1);
+    }
+}
+
+/*
+ * Start the 32768 Hz crystal on XT1 (P5.4/P5.5). Does not wait: ACLK and
+ * the FLL reference stay on REFO via the fail-safe until XT1 is stable.
+ */
+void clock_xt1_start() {
+    P5SEL |= BIT4 | BIT5;
+    UCSCTL6 &= ~XT1OFF;
+    UCSCTL6 |= XCAP_3;                /* internal load capacitance */
+}
+
+/* Clear a stale XT1 fault so ACLK returns to the crystal; true when stable */
+bool clock_xt1_poll() {
+    if (UCSCTL7 & XT1LFOFFG) {
+        UCSCTL7 &= ~XT1LFOFFG;
+        SFRIFG1 &= ~OFIFG;
+        return false;
+    }
+    return true;
+}
+
+bool clock_boosted() {
+    return boost_refs > 0;
+}
+
+uint32_t clock_mclk_hz() {
+    return mclk_hz;
+}
+
+uint32_t clock_smclk_hz() {
+    return mclk_hz;     /* SMCLK and MCLK share DCOCLKDIV /1 */
+}
@@ -0,0 +1,15 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+void clock_boost_acquire();
+void clock_boost_release();
+bool clock_boosted();
+void clock_xt1_start();
+bool clock_xt1_poll();
+uint32_t clock_mclk_hz();
+uint32_t clock_smclk_hz();
+
+#endif
@@ -0,0 +1,35 @@
+#include "cmd_baud.h"
+#include "command.h"
+#include "baud.h"
+#include "uart.h"
+#include <string.h>
+#include <stdlib.h>
+
+/*
+ * BAUD [<rate>|CHECK <pattern>]: propose a console rate (switches after
+ * the ACK, see baud.c) or confirm the test line of a running trial. No
+ * argument prints the current rate.
+ */
+void baud_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if (count == 0) {
+        baud_report();
+        return;
+    }
+    if (strcmp(tokens[0], "CHECK") == 0) {
+        if (!baud_check((count > 1) ? tokens[1] : "")) {
+            uart_puts("No trial running\n");
+        }
+        return;
+    }
+    char *end;
+    unsigned long rate = strtoul(tokens[0], &end, 10);
+    if (end == tokens[0] || *end != '\0' || !baud_supported(rate)) {
+        uart_puts("Bad rate, use 115200|230400|460800|921600\n");
+        return;
+    }
+    if (!baud_propose(rate)) {
+        uart_puts("Trial already running\n");
+    }
+}
+
+REGISTER_COMMAND("BAUD",baud_command);
@@ -0,0 +1,9 @@
+#ifndef CMDBAUD_H
+#define CMDBAUD_H
+
+#include "command.h"
+#include <stdint.h>
+
+void baud_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+
+#endif
@@ -0,0 +1,280 @@
+/**
+ * @file cmd_bench.c
+ * @brief BENCH handlers: console RX/dispatch loopback, TX flood throughput,
+ *        clock boost and main vs USB RAM.
+ *
+ * Benchmarks run to completion inside the command handler, so the
+ * scheduler is stalled for their duration (ISRs keep running and their
+ * cost is included). Elapsed time is accumulated per iteration from the
+ * ~1 us timestamp so runs longer than one timer wrap are measured.
+ */
+
+#include "cmd_bench.h"
+#include "command.h"
+#include "uart.h"
+#include "ticker.h"
+#include "timestamp.h"
+#include "tasks.h"
+#include "clock.h"
+#include "button.h"
+#include "usbram.h"
+#include <stdlib.h>
+
+#define BENCH_DEFAULT_LINES 200
+#define BENCH_DEFAULT_BYTES 1000
+#define BENCH_DEFAULT_BURSTS 20
+#define BURST_SAMPLES 256
+#define BURST_TAPS 16
+#define TIMESTAMP_HZ 1000000UL
+
+static const command_entry_t command_table[] =  {
+    {"BOOST",bench_boost_command},
+    {"CMD",bench_cmd_command},
+#ifdef BUTTON_FSM_BENCH
+    {"FSM",bench_fsm_command},
+#endif
+    {"RAM",bench_ram_command},
+    {"TX",bench_tx_command}
+};
+
+static const uint8_t command_table_size = sizeof(command_table) / sizeof(command_table[0]);
+
+/* Synthetic lines: full tokenize + multi-level dispatch, no side effects */
+static const char * const bench_lines[] = {
+    "LED PX ON",
+    "LOG XYZ 1",
+    "NOP A B"
+};
+
+#define NUM_BENCH_LINES (sizeof(bench_lines) / sizeof(bench_lines[0]))
+
+void bench_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    dispatch_command(tokens,count,command_table,command_table_size);
+}
+
+/* Optional repeat count argument, falling back to a default */
+static uint16_t bench_count(char tokens[][MAX_SC_LENGTH],uint16_t count,uint16_t fallback){
+    if (count == 0) {
+        return fallback;
+    }
+    uint16_t n = (uint16_t)atoi(tokens[0]);
+    return n ? n : fallback;
+}
+
+static void print_header(){
+    uart_puts("\nBAUD ");
+    uart_put_uint32(uart_baud());
+    uart_puts(" TICK ");
+    uart_put_uint16(ticker_period_ms());
+    uart_puts("ms\nTEST N US US/OP OPS/S B/S CPU%\n");
+}
+
+static void print_row(const char* test, uint16_t n, uint32_t total_us, uint32_t bytes, uint32_t busy_us){
+    if (total_us == 0) {
+        total_us = 1;
+    }
+    uart_puts(test);
+    uart_putc(' ');
+    uart_put_uint16(n);
+    uart_putc(' ');
+    uart_put_uint32(total_us);
+    uart_putc(' ');
+    uart_put_uint32(total_us / n);
+    uart_putc(' ');
+    uart_put_uint32((uint32_t)(((uint64_t)n * TIMESTAMP_HZ) / total_us));
+    uart_putc(' ');
+    uart_put_uint32((uint32_t)(((uint64_t)bytes * TIMESTAMP_HZ) / total_us));
+    uart_putc(' ');
+    uart_put_uint16((uint16_t)(((uint64_t)busy_us * 100) / total_us));
+    uart_putc('\n');
+}
+
+/*
+ * BENCH CMD [n]: inject n synthetic lines through the RX path and run the
+ * same consume/tokenize/dispatch code as the RX task, with TX muted.
+ */
+void bench_cmd_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    uint16_t n = bench_count(tokens,count,BENCH_DEFAULT_LINES);
+    uint32_t total = 0;
+    uint32_t bytes = 0;
+
+    uart_loopback(true);
+    for (uint16_t i = 0; i < n; ++i) {
+        const char* line = bench_lines[i % NUM_BENCH_LINES];
+        uint16_t t0 = timestamp_now();
+        uart_inject(line);
+        poll_uart_rx(0);
+        total += (uint16_t)(timestamp_now() - t0);
+        for (const char* c = line; *c; ++c) {
+            ++bytes;
+        }
+        ++bytes;    /* line terminator */
+    }
+    uart_loopback(false);
+
+    print_header();
+    print_row("CMD",n,total,bytes,total);
+}
+
+/*
+ * BENCH TX [n]: blocking flood of n bytes. Time spent spinning on TXIFG
+ * is excluded from the CPU figure.
+ */
+void bench_tx_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    uint16_t n = bench_count(tokens,count,BENCH_DEFAULT_BYTES);
+    uint32_t total = 0;
+    uint32_t wait = 0;
+
+    uart_putc('\n');
+    for (uint16_t i = 0; i < n; ++i) {
+        char c = ((i & 63) == 63) ? '\n' : (char)('0' + (i & 63) % 10);
+        uint16_t t0 = timestamp_now();
+        while (!uart_tx_ready());
+        uint16_t t1 = timestamp_now();
+        uart_putc(c);
+        wait += (uint16_t)(t1 - t0);
+        total += (uint16_t)(timestamp_now() - t0);
+    }
+
+    print_header();
+    print_row("TX",n,total,n,total - wait);
+}
+
+/*
+ * Burst workload: 16-tap Q15 FIR over a 256-sample block, the same
+ * multiply-accumulate shape as an FFT butterfly pass.
+ */
+static int16_t burst_in[BURST_SAMPLES];
+static int16_t burst_usb[BURST_SAMPLES] USBRAM;     /* BENCH RAM copy */
+static volatile int16_t burst_out;
+
+static void burst_fill(int16_t *in){
+    for (uint16_t i = 0; i < BURST_SAMPLES; ++i) {
+        in[i] = (int16_t)((i * 2654435761UL) >> 20);
+    }
+}
+
+static void burst_kernel(const int16_t *in){
+    static const int16_t taps[BURST_TAPS] = {
+        -321, -512, -388, 301, 1603, 3310, 4904, 5799,
+        5799, 4904, 3310, 1603, 301, -388, -512, -321
+    };
+    for (uint16_t i = BURST_TAPS; i < BURST_SAMPLES; ++i) {
+        int32_t acc = 0;
+        for (uint8_t t = 0; t < BURST_TAPS; ++t) {
+            acc += (int32_t)in[i - t] * taps[t];
+        }
+        burst_out = (int16_t)(acc >> 15);
+    }
+}
+
+/*
+ * Run n bursts; per-burst boost includes the clock switch both ways.
+ * Each FLL settle is ~31 ms, so the switch and the work are timed as
+ * separate intervals to stay inside one timestamp wrap.
+ */
+static uint32_t time_bursts(const int16_t *in, uint16_t n, bool boost_each){
+    uint32_t total = 0;
+    for (uint16_t i = 0; i < n; ++i) {
+        uint16_t t0 = timestamp_now();
+        if (boost_each) {
+            clock_boost_acquire();
+        }
+        uint16_t t1 = timestamp_now();
+        burst_kernel(in);
+        uint16_t t2 = timestamp_now();
+        if (boost_each) {
+            clock_boost_release();
+        }
+        uint16_t t3 = timestamp_now();
+        total += (uint16_t)(t1 - t0);
+        total += (uint16_t)(t2 - t1);
+        total += (uint16_t)(t3 - t2);
+    }
+    return total;
+}
+
+/*
+ * BENCH BOOST [n]: time n bursts always-slow, boosted per burst, and
+ * always-fast. Energy per burst is the measured supply power in each
+ * mode (e.g. EnergyTrace) times the US/OP column.
+ */
+void bench_boost_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    uint16_t n = bench_count(tokens,count,BENCH_DEFAULT_BURSTS);
+    uint32_t bytes = (uint32_t)n * sizeof(burst_in);
+
+    burst_fill(burst_in);
+
+    uint32_t slow = time_bursts(burst_in,n,false);
+    uint32_t boost = time_bursts(burst_in,n,true);
+    clock_boost_acquire();
+    uint32_t fast = time_bursts(burst_in,n,false);
+    clock_boost_release();
+
+    print_header();
+    print_row("SLOW",n,slow,bytes,slow);
+    print_row("BOOST",n,boost,bytes,boost);
+    print_row("FAST",n,fast,bytes,fast);
+}
+
+/* Ring-buffer traffic: every word written once and read back once */
+static void ring_kernel(int16_t *buf){
+    for (uint16_t i = 1; i < BURST_SAMPLES; ++i) {
+        buf[i] = (int16_t)(buf[i - 1] + i);
+    }
+}
+
+static uint32_t time_ring(int16_t *buf, uint16_t n){
+    uint32_t total = 0;
+    for (uint16_t i = 0; i < n; ++i) {
+        uint16_t t0 = timestamp_now();
+        ring_kernel(buf);
+        total += (uint16_t)(timestamp_now() - t0);
+    }
+    return total;
+}
+
+/*
+ * BENCH RAM [n]: the burst FIR (reads) and ring traffic (writes + reads)
+ * on identical buffers in main RAM and in USB RAM, boosted, where any
+ * wait state would show most. The rows should match.
+ */
+void bench_ram_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    uint16_t n = bench_count(tokens,count,BENCH_DEFAULT_BURSTS);
+    uint32_t bytes = (uint32_t)n * sizeof(burst_in);
+
+    burst_fill(burst_in);
+    burst_fill(burst_usb);
+    clock_boost_acquire();
+    uint32_t fir_main = time_bursts(burst_in,n,false);
+    uint32_t fir_usb = time_bursts(burst_usb,n,false);
+    uint32_t ring_main = time_ring(burst_in,n);
+    uint32_t ring_usb = time_ring(burst_usb,n);
+    clock_boost_release();
+
+    print_header();
+    print_row("FIR_MAIN",n,fir_main,bytes,fir_main);
+    print_row("FIR_USB",n,fir_usb,bytes,fir_usb);
+    print_row("RING_MAIN",n,ring_main,bytes,ring_main);
+    print_row("RING_USB",n,ring_usb,bytes,ring_usb);
+    uart_puts("USBRAM ");
+    uart_put_uint16(usbram_used());
+    uart_puts(" / ");
+    uart_put_uint16(USBRAM_SIZE);
+    uart_puts(" B\n");
+}
+
+#ifdef BUTTON_FSM_BENCH
+/* BENCH FSM [n]: button HSM vs the hand-written switch, same input */
+void bench_fsm_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    uint16_t n = bench_count(tokens,count,BENCH_DEFAULT_LINES);
+    uint32_t hsm_time, switch_time;
+    button_fsm_bench(n,&hsm_time,&switch_time);
+
+    print_header();
+    print_row("HSM",n,hsm_time,0,hsm_time);
+    print_row("SWITCH",n,switch_time,0,switch_time);
+}
+#endif
+
+REGISTER_COMMAND("BENCH",bench_command);
@@ -0,0 +1,17 @@
+#ifndef CMDBENCH_H
+#define CMDBENCH_H
+
+#include "command.h"
+#include <stdint.h>
+
+void bench_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void bench_boost_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void bench_cmd_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void bench_tx_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void bench_ram_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+
+#ifdef BUTTON_FSM_BENCH
+void bench_fsm_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+#endif
+
+#endif
@@ -0,0 +1,70 @@
+#include "cmd_cusum.h"
+#include "cmd_param.h"
+#include "command.h"
+#include "cusum.h"
+#include "adc.h"
+#include "uart.h"
+#include <string.h>
+
+static const command_entry_t command_table[] =  {
+    {"H",cusum_h_command},
+    {"K",cusum_k_command},
+    {"OFF",cusum_off_command},
+    {"ON",cusum_on_command}
+};
+
+static const uint8_t command_table_size = sizeof(command_table) / sizeof(command_table[0]);
+
+static void print_status(){
+    uart_puts("\nCUSUM ");
+    uart_puts(adc_publish_mode() == ADC_PUBLISH_CUSUM ? "ON" : "OFF");
+    uart_puts(" K ");
+    uart_put_uint16(cusum_k());
+    uart_puts(" H ");
+    uart_put_uint16(cusum_h());
+    uart_puts(" REF ");
+    uart_put_uint16(cusum_reference());
+    uart_puts(" CHG ");
+    uart_put_uint16(cusum_changes());
+    uart_putc('\n');
+}
+
+/* CUSUM [ON|OFF|K <counts>|H <counts>]: no argument prints the status */
+void cusum_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if (count == 0) {
+        print_status();
+        return;
+    }
+    dispatch_command(tokens,count,command_table,command_table_size);
+}
+
+void cusum_on_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    adc_set_publish_mode(ADC_PUBLISH_CUSUM);
+}
+
+void cusum_off_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    adc_set_publish_mode(ADC_PUBLISH_THRESHOLD);
+}
+
+/*
+ * CUSUM K/H <counts> are SET CUSUM_K/CUSUM_H: same range check and the
+ * same detector restart.
+ */
+static void set_param(const char *name, char tokens[][MAX_SC_LENGTH], uint16_t count){
+    char args[2][MAX_SC_LENGTH] = {{0}};
+    strcpy(args[0], name);
+    if (count > 0) {
+        strcpy(args[1], tokens[0]);
+    }
+    param_set_command(args, (count > 0) ? 2 : 1);
+}
+
+void cusum_k_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    set_param("CUSUM_K", tokens, count);
+}
+
+void cusum_h_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    set_param("CUSUM_H", tokens, count);
+}
+
+REGISTER_COMMAND("CUSUM",cusum_command);
@@ -0,0 +1,13 @@
+#ifndef CMDCUSUM_H
+#define CMDCUSUM_H
+
+#include "command.h"
+#include <stdint.h>
+
+void cusum_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void cusum_on_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void cusum_off_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void cusum_k_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void cusum_h_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+
+#endif
@@ -0,0 +1,25 @@
+#include "cmd_fault.h"
+#include "command.h"
+#include "fault.h"
+#include "uart.h"
+
+static const command_entry_t command_table[] =  {
+    {"FAULT",clear_fault_command}
+};
+
+static const uint8_t command_table_size = sizeof(command_table) / sizeof(command_table[0]);
+
+void clear_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    dispatch_command(tokens,count,command_table,command_table_size);
+}
+
+/* CLEAR FAULT: only once the fault line has been released */
+void clear_fault_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if (!fault_clear()) {
+        uart_puts("Fault line still asserted\n");
+        return;
+    }
+    fault_report();
+}
+
+REGISTER_COMMAND("CLEAR",clear_command);
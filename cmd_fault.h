@@ -0,0 +1,10 @@
+#ifndef CMDFAULT_H
+#define CMDFAULT_H
+
+#include "command.h"
+#include <stdint.h>
+
+void clear_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void clear_fault_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+
+#endif
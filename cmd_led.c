@@ -55,3 +55,4 @@ void led_p4_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
 
 }
 
+REGISTER_COMMAND("LED",led_command);
@@ -1,10 +1,32 @@
 #include "cmd_log.h"
 #include "command.h"
 #include "uart.h"
+#include "scheduler.h"
+#include "init.h"
+#include "flash_crc.h"
+#include "power.h"
+#include "analyzer.h"
+#include "adc.h"
+#include "nest.h"
+#include "ticker.h"
+#include "fault.h"
+#include "pipeline.h"
+#include <string.h>
+#include <stdlib.h>
+
+#define ADC_STREAM_DECIMATE 16
 
 
 static const command_entry_t command_table[] =  {
-    {"ADC",log_adc_command}
+    {"AC",log_ac_command},
+    {"ADC",log_adc_command},
+    {"BOOT",log_boot_command},
+    {"CRC",log_crc_command},
+    {"FAULT",log_fault_command},
+    {"LAT",log_lat_command},
+    {"PIPE",log_pipe_command},
+    {"PWR",log_pwr_command},
+    {"STK",log_stk_command}
 };
 
 
@@ -14,10 +36,42 @@ void log_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
         dispatch_command(tokens,count,command_table,command_table_size);
    
 }
+/*
+ * LOG ADC [ON [n]|OFF]: stream every nth A0 sample (default 16, ~460/s)
+ * as binary frames for tools/capture; no argument prints the status.
+ * The stream holds its own ADC12 client.
+ */
 void log_adc_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
-    //todo implement adc logging 
     if( count == 0 ) {
-        uart_puts("ADC Logging not yet implemented\n");
+        uart_puts("\nADC STREAM ");
+        uint16_t n = adc_stream_decimation();
+        if (n == 0) {
+            uart_puts("OFF");
+        } else {
+            uart_puts("ON /");
+            uart_put_uint16(n);
+            uart_puts(" DROP ");
+            uart_put_uint16(adc_stream_drops());
+        }
+        uart_putc('\n');
+        return;
+    }
+    if(strcmp(tokens[0],"ON") == 0) {
+        uint16_t n = (count > 1) ? (uint16_t)atoi(tokens[1]) : ADC_STREAM_DECIMATE;
+        if (n == 0) {
+            n = ADC_STREAM_DECIMATE;
+        }
+        if (adc_stream_decimation() == 0) {
+            power_acquire(PERIPH_ADC12);
+        }
+        adc_stream_enable(n);
+        return;
+    }
+    if(strcmp(tokens[0],"OFF") == 0) {
+        if (adc_stream_decimation() != 0) {
+            adc_stream_enable(0);
+            power_release(PERIPH_ADC12);
+        }
         return;
     }
 
@@ -25,3 +79,121 @@ void log_adc_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
     uart_puts(tokens[0]);
     uart_putc('\n');
 }
+
+/*
+ * LOG AC [ON|OFF]: enable the AC analyzer or print its latest window.
+ * The analyzer holds its own ADC12 client, like the stream.
+ */
+void log_ac_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if( count > 0 ) {
+        if(strcmp(tokens[0],"ON") == 0) {
+            if (!analyzer_enabled()) {
+                power_acquire(PERIPH_ADC12);
+            }
+            analyzer_enable(true);
+            return;
+        }
+        if(strcmp(tokens[0],"OFF") == 0) {
+            if (analyzer_enabled()) {
+                analyzer_enable(false);
+                power_release(PERIPH_ADC12);
+            }
+            return;
+        }
+        uart_puts("Unknown: ");
+        uart_puts(tokens[0]);
+        uart_putc('\n');
+        return;
+    }
+
+    analyzer_result_t r;
+    if (!consume_analyzer_result(&r)) {
+        uart_puts(analyzer_enabled() ? "\nAC no window yet\n" : "\nAC OFF\n");
+        return;
+    }
+    uart_puts("\nAC F_DHZ ");
+    uart_put_uint16(r.freq_dhz);
+    uart_puts(" VPP_MV ");
+    uart_put_uint16(r.vpp_mv);
+    uart_puts(" RMS_MV ");
+    uart_put_uint16(r.rms_mv);
+    uart_puts(" DC_MV ");
+    uart_put_uint16(r.dc_mv);
+    uart_putc('\n');
+}
+
+/* LOG BOOT: boot stage timestamps */
+void log_boot_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    init_report();
+}
+
+/* LOG CRC: flash scrub status */
+void log_crc_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    flash_crc_report();
+}
+
+/* LOG LAT [CLR]: per-task tick->start latency histogram (timestamp counts) */
+void log_lat_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if( count > 0 ) {
+        if(strcmp(tokens[0],"CLR") == 0) {
+            scheduler_clear_latency();
+            return;
+        }
+        uart_puts("Unknown: ");
+        uart_puts(tokens[0]);
+        uart_putc('\n');
+        return;
+    }
+
+    uart_putc('\n');
+    for (uint8_t i = 0; i < scheduler_task_count(); ++i) {
+        const task_t * task = scheduler_task(i);
+        uart_puts(task->name);
+        uart_puts(" max ");
+        uart_put_uint16(task->latency.max);
+        uart_putc('\n');
+        for (uint8_t b = 0; b < LATENCY_BUCKETS; ++b) {
+            if (task->latency.hist[b] == 0) {
+                continue;
+            }
+            uart_puts("  >=");      /* bucket lower bound */
+            uart_put_uint16(b == 0 ? 0 : (uint16_t)(1U << (b - 1)));
+            uart_putc(' ');
+            uart_put_uint16(task->latency.hist[b]);
+            uart_putc('\n');
+        }
+    }
+}
+
+/* LOG PIPE: pipeline stages in run order, calls and samples consumed */
+void log_pipe_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    pipeline_report();
+}
+
+/* LOG PWR: peripheral clients and restart latency (timestamp counts) */
+void log_pwr_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    power_report();
+}
+
+/* LOG FAULT: latch state, trip count and last trip timestamp */
+void log_fault_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    fault_report();
+}
+
+/* LOG STK [CLR]: ISR nesting depth, stack peak and worst tick entry lag */
+void log_stk_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if( count > 0 ) {
+        if(strcmp(tokens[0],"CLR") == 0) {
+            nest_clear();
+            ticker_clear_lag();
+            return;
+        }
+        uart_puts("Unknown: ");
+        uart_puts(tokens[0]);
+        uart_putc('\n');
+        return;
+    }
+    nest_report();
+}
+
+REGISTER_COMMAND("LOG",log_command);
@@ -5,7 +5,15 @@
 #include <stdint.h>
 
 void log_command(char tokens[][MAX_SC_LENGTH],uint16_t count); 
+void log_ac_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
 void log_adc_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void log_boot_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void log_crc_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void log_lat_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void log_pipe_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void log_pwr_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void log_fault_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void log_stk_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
 
 
 #endif
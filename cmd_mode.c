@@ -0,0 +1,22 @@
+#include "cmd_mode.h"
+#include "command.h"
+#include "mode.h"
+#include "uart.h"
+
+/* MODE [NORMAL|ECO|PERF|DIAG]: switch at the next tick boundary; no argument prints the status */
+void mode_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if (count == 0) {
+        mode_report();
+        return;
+    }
+    op_mode_t mode = mode_from_name(tokens[0]);
+    if (mode == MODE_COUNT) {
+        uart_puts("Unknown: ");
+        uart_puts(tokens[0]);
+        uart_putc('\n');
+        return;
+    }
+    mode_request(mode);
+}
+
+REGISTER_COMMAND("MODE",mode_command);
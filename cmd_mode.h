@@ -0,0 +1,9 @@
+#ifndef CMDMODE_H
+#define CMDMODE_H
+
+#include "command.h"
+#include <stdint.h>
+
+void mode_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+
+#endif
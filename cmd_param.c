@@ -0,0 +1,64 @@
+#include "cmd_param.h"
+#include "command.h"
+#include "param.h"
+#include "uart.h"
+#include <stdlib.h>
+
+static void print_param(const param_t *p) {
+    uart_puts("\n");
+    uart_puts(p->name);
+    uart_putc(' ');
+    uart_put_uint16(param_get(p));
+    uart_puts(" (");
+    uart_put_uint16(p->min);
+    uart_puts("..");
+    uart_put_uint16(p->max);
+    uart_puts(")");
+}
+
+/* GET [name]: no argument lists every parameter */
+void get_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if (count == 0) {
+        for (uint8_t i = 0; i < param_count(); ++i) {
+            print_param(param_at(i));
+        }
+        uart_putc('\n');
+        return;
+    }
+    const param_t *p = param_find(tokens[0]);
+    if (!p) {
+        uart_puts("Unknown: ");
+        uart_puts(tokens[0]);
+        uart_putc('\n');
+        return;
+    }
+    print_param(p);
+    uart_putc('\n');
+}
+
+/*
+ * SET <name> <value> for any parameter. Returns false if tokens[0] is
+ * not a parameter so SET can fall back to its own subcommands (DUTY).
+ */
+bool param_set_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    const param_t *p = param_find(tokens[0]);
+    if (!p) {
+        return false;
+    }
+    if (count < 2) {
+        uart_puts("No value provided\n");
+        return true;
+    }
+    char *end;
+    long value = strtol(tokens[1], &end, 10);
+    if (end == tokens[1] || *end != '\0' || value < p->min || value > p->max || !param_set(p, (uint16_t)value)) {
+        uart_puts("Bad value, use ");
+        uart_put_uint16(p->min);
+        uart_puts("..");
+        uart_put_uint16(p->max);
+        uart_putc('\n');
+    }
+    return true;
+}
+
+REGISTER_COMMAND("GET",get_command);
@@ -0,0 +1,11 @@
+#ifndef CMDPARAM_H
+#define CMDPARAM_H
+
+#include "command.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+void get_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+bool param_set_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+
+#endif
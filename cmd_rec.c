@@ -0,0 +1,62 @@
+#include "cmd_rec.h"
+#include "command.h"
+#include "record.h"
+#include "uart.h"
+#include <string.h>
+
+static const command_entry_t command_table[] =  {
+    {"DUMP",rec_dump_command},
+    {"OFF",rec_off_command},
+    {"ON",rec_on_command}
+};
+
+static const uint8_t command_table_size = sizeof(command_table) / sizeof(command_table[0]);
+
+static void print_status(){
+    uart_puts("\nREC ");
+    uart_puts(record_active() ? "ON " : "OFF ");
+    uart_put_uint16(record_count());
+    if (record_full()) {
+        uart_puts(" FULL");
+    }
+    uart_putc('\n');
+}
+
+/* REC [ON [ADC]|OFF|DUMP]: no argument prints the status */
+void rec_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if (count == 0) {
+        print_status();
+        return;
+    }
+    dispatch_command(tokens,count,command_table,command_table_size);
+}
+
+/* REC ON [ADC]: clear the log and record UART + button (+ every ADC sample) */
+void rec_on_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    bool adc = (count > 0 && strcmp(tokens[0],"ADC") == 0);
+    record_start(adc);
+}
+
+void rec_off_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    record_stop();
+    print_status();
+}
+
+/*
+ * REC DUMP: one 8-digit hex line per entry (dt then word), framed by
+ * REC BEGIN / REC END for host/replay. Recording is stopped first so the
+ * dump itself is not logged.
+ */
+void rec_dump_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    record_stop();
+    uart_puts("\nREC BEGIN\n");
+    record_entry_t e;
+    for (uint16_t i = 0; record_entry(i, &e); ++i) {
+        uart_put_hex16(e.dt);
+        uart_put_hex16(e.word);
+        uart_putc('\n');
+    }
+    uart_puts("REC END\n");
+}
+
+REGISTER_COMMAND("REC",rec_command);
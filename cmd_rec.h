@@ -0,0 +1,12 @@
+#ifndef CMDREC_H
+#define CMDREC_H
+
+#include "command.h"
+#include <stdint.h>
+
+void rec_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void rec_dump_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void rec_off_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void rec_on_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+
+#endif
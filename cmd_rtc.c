@@ -0,0 +1,132 @@
+/**
+ * @file cmd_rtc.c
+ * @brief DATE / TIME / ALARM / STANDBY handlers and the scheduled alarm job.
+ *
+ *   DATE [YY-MM-DD]        show or set the date (20YY)
+ *   TIME [HH:MM:SS]        show or set the time
+ *   ALARM [HH:MM [duty]]   daily alarm; optional manual duty applied on match
+ *   ALARM OFF
+ *   STANDBY                stop the tick and sleep until the alarm
+ */
+
+#include "cmd_rtc.h"
+#include "command.h"
+#include "rtc.h"
+#include "uart.h"
+#include "pwm.h"
+#include "tasks.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#define NO_ALARM_DUTY (-1.0f)
+
+static float alarm_duty = NO_ALARM_DUTY;
+
+/* Parse "AA<sep>BB[<sep>CC]" into two-digit fields; returns field count */
+static uint8_t parse_fields(const char* s, char sep, uint8_t out[], uint8_t max){
+    uint8_t n = 0;
+    while (n < max) {
+        if (s[0] < '0' || s[0] > '9' || s[1] < '0' || s[1] > '9') {
+            return 0;
+        }
+        out[n++] = (uint8_t)((s[0] - '0') * 10 + (s[1] - '0'));
+        s += 2;
+        if (*s == '\0') {
+            return n;
+        }
+        if (*s != sep) {
+            return 0;
+        }
+        ++s;
+    }
+    return 0;
+}
+
+static void print_now(){
+    uart_putc('\n');
+    rtc_put_time();
+    uart_putc('\n');
+}
+
+void date_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if (count == 0) {
+        print_now();
+        return;
+    }
+    uint8_t f[3];
+    if (parse_fields(tokens[0],'-',f,3) != 3 || f[1] < 1 || f[1] > 12 || f[2] < 1 || f[2] > 31) {
+        uart_puts("Bad date, use YY-MM-DD\n");
+        return;
+    }
+    rtc_set_date(2000 + f[0],f[1],f[2]);
+    print_now();
+}
+
+void time_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if (count == 0) {
+        print_now();
+        return;
+    }
+    uint8_t f[3];
+    if (parse_fields(tokens[0],':',f,3) != 3 || f[0] > 23 || f[1] > 59 || f[2] > 59) {
+        uart_puts("Bad time, use HH:MM:SS\n");
+        return;
+    }
+    rtc_set_time(f[0],f[1],f[2]);
+    print_now();
+}
+
+void alarm_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if (count == 0) {
+        uint8_t hour, min;
+        if (!rtc_alarm_enabled(&hour,&min)) {
+            uart_puts("\nALARM OFF\n");
+            return;
+        }
+        uart_puts("\nALARM ");
+        uart_put_uint16(hour);
+        uart_putc(':');
+        uart_put_uint16(min);
+        uart_putc('\n');
+        return;
+    }
+    if (strcmp(tokens[0],"OFF") == 0) {
+        rtc_clear_alarm();
+        alarm_duty = NO_ALARM_DUTY;
+        return;
+    }
+    uint8_t f[2];
+    if (parse_fields(tokens[0],':',f,2) != 2 || f[0] > 23 || f[1] > 59) {
+        uart_puts("Bad alarm, use HH:MM\n");
+        return;
+    }
+    alarm_duty = (count > 1) ? (float)atof(tokens[1]) : NO_ALARM_DUTY;
+    rtc_set_alarm(f[0],f[1]);
+}
+
+void standby_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    uint8_t hour, min;
+    if (!rtc_alarm_enabled(&hour,&min)) {
+        uart_puts("\nNo alarm set\n");
+        return;
+    }
+    uart_puts("\nSTANDBY\n");
+    rtc_request_standby();
+}
+
+/* Alarm job: apply the scheduled duty (if any) and log it with wall time */
+void rtc_run_alarm_job(){
+    if (alarm_duty >= 0.0f) {
+        set_duty_from_adc(false);
+        set_pwm_duty_cycle(alarm_duty);
+    }
+    uart_puts("\nALARM ");
+    rtc_put_time();
+    uart_putc('\n');
+}
+
+REGISTER_COMMAND("ALARM",alarm_command);
+REGISTER_COMMAND("DATE",date_command);
+REGISTER_COMMAND("STANDBY",standby_command);
+REGISTER_COMMAND("TIME",time_command);
@@ -0,0 +1,14 @@
+#ifndef CMDRTC_H
+#define CMDRTC_H
+
+#include "command.h"
+#include <stdint.h>
+
+void date_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void time_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void alarm_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void standby_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+
+void rtc_run_alarm_job();
+
+#endif
@@ -0,0 +1,38 @@
+#include "cmd_servo.h"
+#include "command.h"
+#include "servo.h"
+#include "uart.h"
+#include <string.h>
+#include <stdlib.h>
+
+/*
+ * SERVO [<n> <us>|<n> OFF]: move servo n (0..7, P3.n) to a 500..2500 us
+ * pulse, ramped at SERVO_SLW us per frame, or stop its pulses. No
+ * argument prints the status.
+ */
+void servo_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if (count == 0) {
+        servo_report();
+        return;
+    }
+    if (count < 2) {
+        uart_puts("No value provided\n");
+        return;
+    }
+    char *end;
+    long n = strtol(tokens[0], &end, 10);
+    if (end == tokens[0] || *end != '\0' || n < 0 || n >= SERVO_COUNT) {
+        uart_puts("Bad servo, use 0..7\n");
+        return;
+    }
+    if (strcmp(tokens[1], "OFF") == 0) {
+        servo_off((uint8_t)n);
+        return;
+    }
+    long us = strtol(tokens[1], &end, 10);
+    if (end == tokens[1] || *end != '\0' || !servo_set((uint8_t)n, (uint16_t)((us < 0) ? 0 : (us > 0xFFFF) ? 0xFFFF : us))) {
+        uart_puts("Bad pulse, use 500..2500 us\n");
+    }
+}
+
+REGISTER_COMMAND("SERVO",servo_command);
@@ -0,0 +1,9 @@
+#ifndef CMDSERVO_H
+#define CMDSERVO_H
+
+#include "command.h"
+#include <stdint.h>
+
+void servo_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+
+#endif
@@ -4,6 +4,8 @@
 #include "pwm.h"
 #include "uart.h"
 #include <stdlib.h>
+#include "tasks.h"
+#include "cmd_param.h"
 
 
 static const command_entry_t command_table[] =  {
@@ -12,7 +14,11 @@ static const command_entry_t command_table[] =  {
 
 static const uint8_t command_table_size = sizeof(command_table) / sizeof(command_table[0]);
 
+/* SET <param> <value> for any registered parameter, else SET DUTY */
 void set_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+      if (count > 0 && param_set_command(tokens,count)) {
+          return;
+      }
       dispatch_command(tokens,count,command_table,command_table_size);
     
 }
@@ -22,7 +28,14 @@ void set_duty_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
         return;
     }
     
+    if(strcmp(tokens[0],"AUTO") == 0) {  /* back to ADC-driven duty */
+        set_duty_from_adc(true);
+        return;
+    }
+    
     float dc = atof(tokens[0]);  //todo use strof with proper error handling 
+    set_duty_from_adc(false);       /* manual duty: ADC no longer needed */
     set_pwm_duty_cycle(dc);
 }
 
+REGISTER_COMMAND("SET",set_command);
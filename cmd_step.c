@@ -0,0 +1,45 @@
+#include "cmd_step.h"
+#include "command.h"
+#include "stepper.h"
+#include "uart.h"
+#include <string.h>
+#include <stdlib.h>
+
+/*
+ * STEP [<steps>|STOP|OFF]: move by up to STEP_MAX_STEPS full steps
+ * (negative reverses), ramp down and stop, or release the coils. No
+ * argument prints the status.
+ * Rate, acceleration and microstepping are the STEP_RATE, STEP_ACC and
+ * STEP_DIV parameters (SET/GET).
+ */
+void step_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if (count == 0) {
+        stepper_report();
+        return;
+    }
+    if (strcmp(tokens[0], "STOP") == 0) {
+        stepper_halt();
+        return;
+    }
+    if (strcmp(tokens[0], "OFF") == 0) {
+        stepper_disable();
+        return;
+    }
+    char *end;
+    long steps = strtol(tokens[0], &end, 10);
+    if (end == tokens[0] || *end != '\0') {
+        uart_puts("Unknown: ");
+        uart_puts(tokens[0]);
+        uart_putc('\n');
+        return;
+    }
+    if (steps > STEP_MAX_STEPS || steps < -STEP_MAX_STEPS) {
+        uart_puts("Bad steps, use -1000000..1000000\n");
+        return;
+    }
+    if (!stepper_move(steps)) {
+        uart_puts("Busy or fault\n");
+    }
+}
+
+REGISTER_COMMAND("STEP",step_command);
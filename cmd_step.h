@@ -0,0 +1,9 @@
+#ifndef CMDSTEP_H
+#define CMDSTEP_H
+
+#include "command.h"
+#include <stdint.h>
+
+void step_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+
+#endif
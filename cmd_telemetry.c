@@ -0,0 +1,53 @@
+#include "cmd_telemetry.h"
+#include "command.h"
+#include "telemetry.h"
+#include "uart.h"
+#include <string.h>
+#include <stdlib.h>
+
+static void bad_topic(){
+    uart_puts("Bad topic, use ADC|DUTY|BTN|TASKS\n");
+}
+
+/*
+ * SUB [<topic> <ms>|<topic> CHG]: push a topic every ms (1..60000) or
+ * whenever it changes, in telemetry frames. No argument lists the
+ * subscriptions.
+ */
+void sub_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if (count == 0) {
+        telemetry_report();
+        return;
+    }
+    if (count < 2) {
+        uart_puts("No value provided\n");
+        return;
+    }
+    uint16_t ms = TELEM_ON_CHANGE;
+    if (strcmp(tokens[1], "CHG") != 0) {
+        char *end;
+        long v = strtol(tokens[1], &end, 10);
+        if (end == tokens[1] || *end != '\0' || v < 1 || v > (long)TELEM_MAX_MS) {
+            uart_puts("Bad rate, use 1..60000 ms or CHG\n");
+            return;
+        }
+        ms = (uint16_t)v;
+    }
+    if (!telemetry_subscribe(tokens[0], ms)) {
+        bad_topic();
+    }
+}
+
+/* UNSUB <topic|ALL>: stop pushing a topic */
+void unsub_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if (count == 0) {
+        uart_puts("No value provided\n");
+        return;
+    }
+    if (!telemetry_unsubscribe(tokens[0])) {
+        bad_topic();
+    }
+}
+
+REGISTER_COMMAND("SUB",sub_command);
+REGISTER_COMMAND("UNSUB",unsub_command);
@@ -0,0 +1,10 @@
+#ifndef CMDTELEMETRY_H
+#define CMDTELEMETRY_H
+
+#include "command.h"
+#include <stdint.h>
+
+void sub_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+void unsub_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+
+#endif
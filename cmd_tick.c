@@ -0,0 +1,28 @@
+#include "cmd_tick.h"
+#include "command.h"
+#include "scheduler.h"
+#include "ticker.h"
+#include "uart.h"
+#include <stdlib.h>
+
+/*
+ * TICK [ms]: print or change the tick period. Task periods, button
+ * debounce/hold and other ms timings are kept; the change is applied at
+ * the next tick boundary.
+ */
+void tick_command(char tokens[][MAX_SC_LENGTH],uint16_t count){
+    if (count == 0) {
+        uart_puts("\nTICK ");
+        uart_put_uint16(ticker_period_ms());
+        uart_puts(" ms\n");
+        return;
+    }
+    long ms = atol(tokens[0]);
+    if (ms < TICK_MS_MIN || ms > TICK_MS_MAX) {
+        uart_puts("Bad tick, use 1..1999 ms\n");
+        return;
+    }
+    scheduler_request_tick_ms((uint16_t)ms);
+}
+
+REGISTER_COMMAND("TICK",tick_command);
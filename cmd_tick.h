@@ -0,0 +1,9 @@
+#ifndef CMDTICK_H
+#define CMDTICK_H
+
+#include "command.h"
+#include <stdint.h>
+
+void tick_command(char tokens[][MAX_SC_LENGTH],uint16_t count);
+
+#endif
@@ -6,21 +6,10 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdbool.h>
-#include "cmd_led.h"
-#include "cmd_set.h"
-#include "cmd_log.h"
 
+/* Top-level commands are registered by their cmd_*.c modules (REGISTER_COMMAND) */
 
 
-static const command_entry_t command_table[] =  {
-    {"LED", led_command},
-    {"LOG",log_command},
-    {"SET",set_command},
-};
-
-
-static const uint8_t command_table_size = sizeof(command_table) / sizeof(command_table[0]);
-
 
 
 uint16_t tokenize(const char command[], char tokenized[][MAX_SC_LENGTH]) {
@@ -46,7 +35,8 @@ uint16_t tokenize(const char command[], char tokenized[][MAX_SC_LENGTH]) {
     return word_index;    // there is now some valid command in tokenized (could be completely empty )
 }
 
-void dispatch_command(
+/* Look up tokens[0] in table; prints why and returns NULL if it is not there */
+static const command_entry_t* find_command(
     char tokens[][MAX_SC_LENGTH],
     uint16_t count,
     const command_entry_t* table,
@@ -54,23 +44,43 @@ void dispatch_command(
 ) {
     if (count == 0) {
         uart_puts("Missing command\n");
-        return;
+        return NULL;
     }
     uart_puts(tokens[0]);
     for (uint16_t i = 0; i < table_size; ++i) {
         if (strcmp(tokens[0], table[i].name) == 0) {
-            table[i].handler(tokens + 1, count - 1);
-            return;
+            return &table[i];
         }
     }
     
     uart_puts("Unknown: ");
     uart_puts(tokens[0]);
     uart_putc('\n');
+    return NULL;
 }
 
-void parse_command(char tokens[][MAX_SC_LENGTH],uint16_t count) {
-    dispatch_command(tokens,count,command_table,command_table_size);
-  }
-
+/* Sub-command tables of the cmd_*.c handlers */
+void dispatch_command(
+    char tokens[][MAX_SC_LENGTH],
+    uint16_t count,
+    const command_entry_t* table,
+    uint8_t table_size
+) {
+    const command_entry_t* entry = find_command(tokens, count, table, table_size);
+    if (entry) {
+        entry->handler(tokens + 1, count - 1);
+    }
+}
 
+/*
+ * Top-level commands. The handler is called here rather than through
+ * dispatch_command, so top-level and sub-command handlers are separate
+ * indirect call sites and the call graph has no cycle (tools/wcet.py).
+ */
+void parse_command(char tokens[][MAX_SC_LENGTH],uint16_t count) {
+    const command_entry_t* entry =
+        find_command(tokens, count, REGISTRY_START(cmds), REGISTRY_COUNT(cmds));
+    if (entry) {
+        entry->handler(tokens + 1, count - 1);
+    }
+}
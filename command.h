@@ -1,6 +1,7 @@
 #ifndef COMMAND_H
 #define COMMAND_H
 #include <stdint.h>
+#include "registry.h"
 
 
 #define MAX_COMMAND_ARGS 3
@@ -15,6 +16,12 @@ typedef struct {
     command_handler_t handler;
 } command_entry_t;
 
+/* Register a top-level console command; dispatch order is by name */
+#define REGISTER_COMMAND(name, handler) \
+    static const command_entry_t REGISTRY_CAT(cmd_reg_, handler) REGISTRY_ENTRY(command_entry_t, cmds, name) = { name, handler }
+
+REGISTRY_TABLE(command_entry_t, cmds);
+
 
 
 void parse_command(char tokens[][MAX_SC_LENGTH],uint16_t count); 
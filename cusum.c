@@ -0,0 +1,90 @@
+/**
+ * @file cusum.c
+ * @brief Two-sided CUSUM (Page-Hinkley) mean-shift detector for raw ADC samples.
+ *
+ * After a reset the reference mean is learned from the next 16 samples
+ * (their sum is the mean in Q4) and then frozen, so slow drifts keep
+ * accumulating instead of being tracked away. Per sample:
+ *
+ *   d  = x - ref
+ *   g+ = max(0, g+ + d - k)      g- = max(0, g- - d - k)
+ *
+ * and a statistic above h reports a shift (+1 up, -1 down) and restarts
+ * learning at the new level. k is the allowed slack (about half the
+ * smallest shift of interest), h trades detection delay against false
+ * alarms; an isolated spike of size A only fires if A - k > h.
+ *
+ * All arithmetic is 16-bit add/compare, cheap enough for the ADC ISR.
+ * g stays below h + 4095, hence CUSUM_H_MAX.
+ */
+
+#include "cusum.h"
+
+#define LEARN_SAMPLES 16
+
+volatile uint16_t cusum_slack = 8;          /* k, raw counts; param CUSUM_K */
+volatile uint16_t cusum_limit = 200;        /* h, raw counts; param CUSUM_H */
+static uint16_t ref = 0;
+static uint16_t learn_sum = 0;
+static uint8_t learn_count = 0;
+static int16_t g_pos = 0;
+static int16_t g_neg = 0;
+static uint16_t changes = 0;
+
+void cusum_reset() {
+    learn_sum = 0;
+    learn_count = 0;
+    g_pos = 0;
+    g_neg = 0;
+}
+
+/* Feed one 12-bit sample; returns +1/-1 on a detected shift, else 0 */
+int8_t cusum_update(uint16_t x) {
+    if (learn_count < LEARN_SAMPLES) {
+        learn_sum += x;                     /* 16 x 4095 fits in 16 bits */
+        if (++learn_count == LEARN_SAMPLES) {
+            ref = learn_sum >> 4;
+        }
+        return 0;
+    }
+
+    int16_t d = (int16_t)(x - ref);
+    int16_t slack = (int16_t)cusum_slack;
+
+    g_pos += d - slack;
+    if (g_pos < 0) {
+        g_pos = 0;
+    }
+    g_neg -= d + slack;
+    if (g_neg < 0) {
+        g_neg = 0;
+    }
+
+    int8_t dir = 0;
+    if (g_pos > (int16_t)cusum_limit) {
+        dir = 1;
+    } else if (g_neg > (int16_t)cusum_limit) {
+        dir = -1;
+    }
+    if (dir) {
+        ++changes;
+        cusum_reset();
+    }
+    return dir;
+}
+
+uint16_t cusum_k() {
+    return cusum_slack;
+}
+
+uint16_t cusum_h() {
+    return cusum_limit;
+}
+
+uint16_t cusum_reference() {
+    return ref;
+}
+
+uint16_t cusum_changes() {
+    return changes;
+}
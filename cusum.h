@@ -0,0 +1,20 @@
+#ifndef CUSUM_H
+#define CUSUM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CUSUM_H_MAX 16000
+
+extern volatile uint16_t cusum_slack;
+extern volatile uint16_t cusum_limit;
+
+void cusum_reset();
+int8_t cusum_update(uint16_t x);
+
+uint16_t cusum_k();
+uint16_t cusum_h();
+uint16_t cusum_reference();
+uint16_t cusum_changes();
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file fault.c
+ * @brief Latched PWM shutdown on an external fault line (P2.0, active low).
+ *
+ * A falling edge on P2.0 (pull-up; overcurrent/over-temperature sources
+ * are usually open drain) runs the PORT2 ISR, whose first instruction
+ * returns P1.2 to GPIO, where P1OUT holds it low; the stepper enables
+ * (P2.4/P2.5, TA2.1/TA2.2) follow the same way. TA0.1 is then forced
+ * to OUTMOD_0 (OUT = 0) so the timer output is also inactive if P1SEL is
+ * set again before the fault is cleared.
+ *
+ * The ISR body only uses immediate/absolute-to-absolute instructions, so
+ * the compiler emits no register saves ahead of it. Edge to pin low is
+ * the interrupt entry (6 cycles, plus up to 5 to finish the current
+ * instruction) and one BIC.B (4 cycles): about 15 MCLK cycles, ~0.9 us
+ * with the clock boosted (16 MHz) and ~15 us at the default ~1 MHz.
+ * Leaving LPM3 adds the DCO/PMM wake time, and code running with GIE
+ * clear (the analyzer MAC, scheduler rescale) delays it further. A
+ * guaranteed sub-microsecond cutoff needs a hardware path (gate driver
+ * enable) rather than an ISR.
+ *
+ * The fault stays latched, with the edge interrupt disarmed, until
+ * fault_clear() (CLEAR FAULT) finds the line released.
+ */
+
+#include "fault.h"
+#include <msp430.h>
+#include "pwm.h"
+#include "stepper.h"
+#include "uart.h"
+
+#define FAULT_PIN BIT0      /* P2.0 */
+
+static volatile bool latched = false;
+static volatile uint16_t trips = 0;
+static volatile uint16_t trip_stamp = 0;    /* Timer_B0 count at the trip */
+
+/* Same steps as the ISR, for a line that is already low when armed */
+static void trip() {
+    P1SEL &= ~BIT2;
+    P2SEL &= ~(BIT4 | BIT5);
+    TA0CCTL1 &= ~OUTMOD_7;
+    trip_stamp = TB0R;
+    latched = true;
+    ++trips;
+}
+
+/* Pull-up input, falling edge; after pwm_init (P1.2 parked low) */
+void fault_init() {
+    P2DIR &= ~FAULT_PIN;
+    P2OUT |= FAULT_PIN;
+    P2REN |= FAULT_PIN;
+    P2IES |= FAULT_PIN;         /* high -> low */
+    P2IFG &= ~FAULT_PIN;        /* writing IES may set the flag */
+    if (!(P2IN & FAULT_PIN)) {
+        trip();
+        return;
+    }
+    P2IE |= FAULT_PIN;
+}
+
+bool fault_latched() {
+    return latched;
+}
+
+/*
+ * CLEAR FAULT: give the outputs back and re-arm; false while the line is
+ * still low. Runs with GIE clear so the ISR cannot trip between the
+ * outputs being restored and the latch dropping. The flag is cleared
+ * before the line is sampled: an edge after that sets it again and, once
+ * P2IE is set below, trips as soon as GIE is back.
+ */
+bool fault_clear() {
+    if (!latched) {
+        return true;
+    }
+    __disable_interrupt();
+    P2IFG &= ~FAULT_PIN;
+    if (!(P2IN & FAULT_PIN)) {
+        __enable_interrupt();
+        return false;
+    }
+    pwm_fault_release();
+    stepper_fault_release();
+    latched = false;
+    P2IE |= FAULT_PIN;
+    __enable_interrupt();
+    return true;
+}
+
+void fault_report() {
+    uart_puts("\nFAULT ");
+    uart_puts(latched ? "LATCHED" : "OK");
+    uart_puts(" LINE ");
+    uart_puts((P2IN & FAULT_PIN) ? "HIGH" : "LOW");
+    uart_puts(" TRIPS ");
+    uart_put_uint16(trips);
+    uart_puts(" AT ");
+    uart_put_uint16(trip_stamp);
+    uart_putc('\n');
+}
+
+/*
+ * PORT2 ISR: P2.0 is the only enabled source. Outputs first; the flag is
+ * cleared and the edge disarmed so a bouncing line does not re-enter.
+ */
+#pragma vector=PORT2_VECTOR
+__interrupt void port2_isr() {
+    P1SEL &= ~BIT2;             /* P1.2 -> GPIO, P1OUT.2 = 0 */
+    P2SEL &= ~(BIT4 | BIT5);    /* stepper enables -> GPIO low */
+    TA0CCTL1 &= ~OUTMOD_7;      /* OUTMOD_0, OUT = 0 */
+    trip_stamp = TB0R;
+    latched = true;
+    ++trips;
+    P2IE &= ~FAULT_PIN;
+    P2IFG &= ~FAULT_PIN;
+}
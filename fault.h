@@ -0,0 +1,12 @@
+#ifndef FAULT_H
+#define FAULT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+void fault_init();
+bool fault_latched();
+bool fault_clear();
+void fault_report();
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef FLASH_CRC_H
+#define FLASH_CRC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+void flash_crc_init();
+void flash_crc_idle();
+bool consume_crc_alarm_event();
+void flash_crc_report();
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * @file msp430.c
+ * @brief Register storage and the few emulated behaviours of host/msp430.h.
+ */
+
+#include <msp430.h>
+#include <stdio.h>
+
+#define HOST_DEFINE_REGISTER(r) volatile uint16_t r;
+HOST_REGISTERS(HOST_DEFINE_REGISTER)
+
+volatile uint16_t host_sr = 0;
+
+static volatile uint16_t tx_slot;
+static int tx_pending = 0;
+
+volatile uint16_t *host_uart_tx_slot(void) {
+    host_uart_tx_flush();
+    tx_pending = 1;
+    return &tx_slot;
+}
+
+void host_uart_tx_flush(void) {
+    if (tx_pending) {
+        putchar((char)tx_slot);
+        tx_pending = 0;
+    }
+}
+
+volatile int16_t host_macs;
+volatile int16_t host_op2;
+volatile uint8_t host_mac_armed = 0;
+static volatile uint16_t res[2];
+
+volatile uint16_t *host_mpy_result(uint8_t word) {
+    if (host_mac_armed) {
+        host_mac_armed = 0;
+        uint32_t acc = ((uint32_t)res[1] << 16) | res[0];
+        acc += (uint32_t)((int32_t)host_macs * host_op2);
+        res[0] = (uint16_t)acc;
+        res[1] = (uint16_t)(acc >> 16);
+    }
+    return &res[word];
+}
+
+uint16_t __get_SP_register(void) {
+    return 0;
+}
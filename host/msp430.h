@@ -0,0 +1,316 @@
+#ifndef HOST_MSP430_H
+#define HOST_MSP430_H
+
+/*
+ * Host stand-in for <msp430.h>: peripheral registers become plain
+ * variables (host/msp430.c) so the firmware sources compile and run
+ * unmodified on a PC. Bit values match msp430f5529.h. Only what the
+ * tree uses is defined; add registers and bits here as drivers grow.
+ *
+ * Behaviour beyond storage:
+ * - UCA1TXBUF writes are collected as console output
+ * - MACS/OP2 -> RESHI:RESLO performs the signed multiply-accumulate
+ * - __data20_read_char() reads erased flash (0xFF)
+ */
+
+#include <stdint.h>
+
+#define HOST_REGISTERS(X) \
+    X(WDTCTL) \
+    X(TA0CTL) X(TA0R) X(TA0CCTL0) X(TA0CCTL1) X(TA0CCTL2) X(TA0CCTL3) X(TA0CCTL4) \
+    X(TA0CCR0) X(TA0CCR1) X(TA0CCR2) X(TA0CCR3) X(TA0CCR4) X(TA0EX0) X(TA0IV) \
+    X(TA1CTL) X(TA1R) X(TA1CCTL0) X(TA1CCTL1) X(TA1CCR0) X(TA1CCR1) X(TA1EX0) X(TA1IV) \
+    X(TA2CTL) X(TA2R) X(TA2CCTL0) X(TA2CCTL1) X(TA2CCTL2) X(TA2CCR0) X(TA2CCR1) X(TA2CCR2) \
+    X(TA2EX0) X(TA2IV) \
+    X(TB0CTL) X(TB0R) X(TB0CCTL0) X(TB0CCTL1) X(TB0CCTL2) X(TB0CCTL3) X(TB0CCTL4) \
+    X(TB0CCTL5) X(TB0CCTL6) X(TB0CCR0) X(TB0CCR1) X(TB0CCR2) X(TB0CCR3) X(TB0CCR4) \
+    X(TB0CCR5) X(TB0CCR6) X(TB0EX0) X(TB0IV) \
+    X(ADC12CTL0) X(ADC12CTL1) X(ADC12CTL2) X(ADC12IFG) X(ADC12IE) X(ADC12IV) \
+    X(ADC12MEM0) X(ADC12MCTL0) \
+    X(UCA1CTL0) X(UCA1CTL1) X(UCA1BR0) X(UCA1BR1) X(UCA1BRW) X(UCA1MCTL) X(UCA1IE) \
+    X(UCA1IFG) X(UCA1IV) X(UCA1RXBUF) X(UCA1STAT) \
+    X(P1DIR) X(P1OUT) X(P1IN) X(P1SEL) X(P1REN) X(P1IE) X(P1IES) X(P1IFG) X(P1IV) \
+    X(P2DIR) X(P2OUT) X(P2IN) X(P2SEL) X(P2REN) X(P2IE) X(P2IES) X(P2IFG) X(P2IV) \
+    X(P3DIR) X(P3OUT) X(P3IN) X(P3SEL) X(P3REN) \
+    X(P4DIR) X(P4OUT) X(P4IN) X(P4SEL) X(P4REN) \
+    X(P5DIR) X(P5OUT) X(P5SEL) X(P6DIR) X(P6OUT) X(P6SEL) X(PJDIR) X(PJOUT) \
+    X(UCSCTL0) X(UCSCTL1) X(UCSCTL2) X(UCSCTL3) X(UCSCTL4) X(UCSCTL5) X(UCSCTL6) \
+    X(UCSCTL7) X(UCSCTL8) X(SFRIFG1) X(SFRIE1) \
+    X(PMMCTL0) X(PMMCTL0_H) X(PMMCTL0_L) X(PMMIFG) X(PMMRIE) X(SVSMHCTL) X(SVSMLCTL) X(SVSMIO) \
+    X(CRCDI) X(CRCDIRB) X(CRCDIRB_L) X(CRCINIRES) X(CRCRESR) \
+    X(RTCCTL01) X(RTCCTL0) X(RTCCTL1) X(RTCCTL23) X(RTCPS0CTL) X(RTCPS1CTL) X(RTCIV) \
+    X(RTCSEC) X(RTCMIN) X(RTCHOUR) X(RTCDOW) X(RTCDAY) X(RTCMON) X(RTCYEAR) \
+    X(RTCAMIN) X(RTCAHOUR) X(RTCADOW) X(RTCADAY) \
+    X(MPY) X(MPYS) X(MAC) X(SUMEXT) X(MPY32CTL0) \
+    X(USBKEYPID) X(USBCNF) X(USBPWRCTL) X(USBPLLCTL)
+
+#define HOST_DECLARE_REGISTER(r) extern volatile uint16_t r;
+HOST_REGISTERS(HOST_DECLARE_REGISTER)
+
+/* Console TX: every write lands in a fresh slot, emitted by the next one */
+volatile uint16_t *host_uart_tx_slot(void);
+void host_uart_tx_flush(void);
+#define UCA1TXBUF (*host_uart_tx_slot())
+
+/* MPY32: writing OP2 arms the MAC, reading the result performs it */
+extern volatile int16_t host_macs;
+extern volatile int16_t host_op2;
+extern volatile uint8_t host_mac_armed;
+volatile uint16_t *host_mpy_result(uint8_t word);
+#define MACS  host_macs
+#define OP2   (*(host_mac_armed = 1, &host_op2))
+#define RESLO (*host_mpy_result(0))
+#define RESHI (*host_mpy_result(1))
+
+/* Status register (only GIE and the LPM bits are meaningful) */
+extern volatile uint16_t host_sr;
+#define __interrupt
+#define __even_in_range(x,y) (x)
+#define __bis_SR_register(x) ((void)(host_sr |= (x)))
+#define __bic_SR_register(x) ((void)(host_sr &= ~(x)))
+#define __bis_SR_register_on_exit(x) ((void)(x))
+#define __bic_SR_register_on_exit(x) ((void)(x))
+#define __enable_interrupt() ((void)(host_sr |= GIE))
+#define __disable_interrupt() ((void)(host_sr &= ~GIE))
+#define __get_SR_register() (host_sr)
+#define __get_interrupt_state() (host_sr & GIE)
+#define __set_interrupt_state(x) ((void)(host_sr = (host_sr & ~GIE) | ((x) & GIE)))
+uint16_t __get_SP_register(void);
+#define __no_operation() ((void)0)
+#define __delay_cycles(x) ((void)(x))
+#define __data20_read_char(a) ((void)(a), (unsigned char)0xFF)
+
+#define BIT0 (0x0001)
+#define BIT1 (0x0002)
+#define BIT2 (0x0004)
+#define BIT3 (0x0008)
+#define BIT4 (0x0010)
+#define BIT5 (0x0020)
+#define BIT6 (0x0040)
+#define BIT7 (0x0080)
+#define BIT8 (0x0100)
+#define BIT9 (0x0200)
+#define BITA (0x0400)
+#define BITB (0x0800)
+#define BITC (0x1000)
+#define BITD (0x2000)
+#define BITE (0x4000)
+#define BITF (0x8000)
+
+/* SR */
+#define GIE        (0x0008)
+#define CPUOFF     (0x0010)
+#define OSCOFF     (0x0020)
+#define SCG0       (0x0040)
+#define SCG1       (0x0080)
+#define LPM0_bits  (CPUOFF)
+#define LPM3_bits  (SCG1 + SCG0 + CPUOFF)
+#define LPM4_bits  (SCG1 + SCG0 + OSCOFF + CPUOFF)
+
+/* WDT */
+#define WDTPW      (0x5A00)
+#define WDTHOLD    (0x0080)
+
+/* Timer_A / Timer_B */
+#define TASSEL_1       (0x0100)
+#define TASSEL_2       (0x0200)
+#define TASSEL__ACLK   (0x0100)
+#define TASSEL__SMCLK  (0x0200)
+#define TBSSEL_1       (0x0100)
+#define TBSSEL_2       (0x0200)
+#define TBSSEL__ACLK   (0x0100)
+#define TBSSEL__SMCLK  (0x0200)
+#define ID_0           (0x0000)
+#define ID_1           (0x0040)
+#define ID_2           (0x0080)
+#define ID_3           (0x00C0)
+#define ID__1          (0x0000)
+#define ID__2          (0x0040)
+#define ID__4          (0x0080)
+#define ID__8          (0x00C0)
+#define MC_0           (0x0000)
+#define MC_1           (0x0010)
+#define MC_2           (0x0020)
+#define MC_3           (0x0030)
+#define MC__STOP       (0x0000)
+#define MC__UP         (0x0010)
+#define MC__CONTINUOUS (0x0020)
+#define TACLR          (0x0004)
+#define TAIE           (0x0002)
+#define TAIFG          (0x0001)
+#define TBCLR          (0x0004)
+#define TBIE           (0x0002)
+#define TBIFG          (0x0001)
+#define CAP            (0x0100)
+#define OUTMOD_0       (0x0000)
+#define OUTMOD_1       (0x0020)
+#define OUTMOD_2       (0x0040)
+#define OUTMOD_3       (0x0060)
+#define OUTMOD_4       (0x0080)
+#define OUTMOD_5       (0x00A0)
+#define OUTMOD_6       (0x00C0)
+#define OUTMOD_7       (0x00E0)
+#define CCIE           (0x0010)
+#define OUT            (0x0004)
+#define CCIFG          (0x0001)
+#define TAIDEX_0       (0x0000)
+#define TAIDEX_1       (0x0001)
+#define TAIDEX_2       (0x0002)
+#define TAIDEX_3       (0x0003)
+#define TAIDEX_4       (0x0004)
+#define TAIDEX_5       (0x0005)
+#define TAIDEX_6       (0x0006)
+#define TAIDEX_7       (0x0007)
+#define TBIDEX_0       (0x0000)
+#define TBIDEX_1       (0x0001)
+
+/* ADC12_A */
+#define ADC12SC         (0x0001)
+#define ADC12ENC        (0x0002)
+#define ADC12ON         (0x0010)
+#define ADC12REFON      (0x0020)
+#define ADC12MSC        (0x0080)
+#define ADC12SHT0_2     (0x0200)
+#define ADC12SHT0_6     (0x0600)
+#define ADC12BUSY       (0x0001)
+#define ADC12CONSEQ_2   (0x0004)
+#define ADC12CONSEQ_3   (0x0006)
+#define ADC12SSEL0      (0x0008)
+#define ADC12SSEL1      (0x0010)
+#define ADC12DIV0       (0x0020)
+#define ADC12DIV1       (0x0040)
+#define ADC12DIV2       (0x0080)
+#define ADC12DIV_0      (0x0000)
+#define ADC12DIV_1      (0x0020)
+#define ADC12DIV_2      (0x0040)
+#define ADC12DIV_3      (0x0060)
+#define ADC12DIV_4      (0x0080)
+#define ADC12DIV_5      (0x00A0)
+#define ADC12DIV_6      (0x00C0)
+#define ADC12DIV_7      (0x00E0)
+#define ADC12SHP        (0x0200)
+#define ADC12SHS0       (0x0400)
+#define ADC12SHS1       (0x0800)
+#define ADC12CSTARTADD0 (0x1000)
+#define ADC12CSTARTADD1 (0x2000)
+#define ADC12CSTARTADD2 (0x4000)
+#define ADC12CSTARTADD3 (0x8000)
+#define ADC12RES_2      (0x0020)
+#define ADC12PDIV       (0x0100)
+#define ADC12PDIV_1     (0x0100)
+#define ADC12INCH0      (0x0001)
+#define ADC12INCH1      (0x0002)
+#define ADC12INCH2      (0x0004)
+#define ADC12INCH3      (0x0008)
+#define ADC12SREF0      (0x0010)
+#define ADC12SREF1      (0x0020)
+#define ADC12SREF2      (0x0040)
+#define ADC12EOS        (0x0080)
+#define ADC12IE0        (0x0001)
+#define ADC12IV_ADC12IFG0 (0x0006)
+
+/* USCI_A */
+#define UCSWRST        (0x01)
+#define UCSSEL_2       (0x80)
+#define UCSSEL__SMCLK  (0x80)
+#define UCOS16         (0x01)
+#define UCBRS0         (0x02)
+#define UCBRS_1        (0x02)
+#define UCBRF0         (0x10)
+#define UCBRF_0        (0x00)
+#define UCBUSY         (0x01)
+#define UCRXIE         (0x0001)
+#define UCTXIE         (0x0002)
+#define UCRXIFG        (0x0001)
+#define UCTXIFG        (0x0002)
+
+/* UCS / SFR */
+#define DCORSEL_0      (0x0000)
+#define DCORSEL_1      (0x0010)
+#define DCORSEL_2      (0x0020)
+#define DCORSEL_3      (0x0030)
+#define DCORSEL_4      (0x0040)
+#define DCORSEL_5      (0x0050)
+#define DCORSEL_6      (0x0060)
+#define DCORSEL_7      (0x0070)
+#define FLLD_0         (0x0000)
+#define FLLD_1         (0x1000)
+#define FLLD_2         (0x2000)
+#define SELREF_0       (0x0000)
+#define SELREF_2       (0x0020)
+#define SELA__XT1CLK   (0x0000)
+#define SELA__REFOCLK  (0x0200)
+#define SELS__DCOCLKDIV (0x0040)
+#define SELM__DCOCLKDIV (0x0004)
+#define DIVS__1        (0x0000)
+#define DIVS__16       (0x0040)
+#define DIVM__1        (0x0000)
+#define XT1OFF         (0x0001)
+#define XCAP_3         (0x000C)
+#define XT1DRIVE_0     (0x0000)
+#define XT1DRIVE_3     (0x00C0)
+#define DCOFFG         (0x0001)
+#define XT1LFOFFG      (0x0002)
+#define XT2OFFG        (0x0008)
+#define ACLKREQEN      (0x0001)
+#define MCLKREQEN      (0x0002)
+#define SMCLKREQEN     (0x0004)
+#define OFIFG          (0x0002)
+
+/* PMM */
+#define PMMPW          (0xA500)
+#define PMMPW_H        (0xA5)
+#define PMMCOREV0      (0x0001)
+#define PMMCOREV1      (0x0002)
+#define PMMCOREV_0     (0x0000)
+#define PMMCOREV_1     (0x0001)
+#define PMMCOREV_2     (0x0002)
+#define PMMCOREV_3     (0x0003)
+#define SVSMLDLYIFG    (0x0001)
+#define SVMLIFG        (0x0002)
+#define SVMLVLRIFG     (0x0004)
+#define SVSMHDLYIFG    (0x0010)
+#define SVMHIFG        (0x0020)
+#define SVMHVLRIFG     (0x0040)
+#define SVSMHRRL0      (0x0001)
+#define SVSMHRRL_0     (0x0000)
+#define SVSMHDLYST     (0x0008)
+#define SVSHMD         (0x0010)
+#define SVSMHACE       (0x0080)
+#define SVSHRVL0       (0x0100)
+#define SVSHRVL_0      (0x0000)
+#define SVSHE          (0x0400)
+#define SVSHFP         (0x0800)
+#define SVMHE          (0x4000)
+#define SVMHFP         (0x8000)
+#define SVSMLRRL0      (0x0001)
+#define SVSMLRRL_0     (0x0000)
+#define SVSMLDLYST     (0x0008)
+#define SVSLMD         (0x0010)
+#define SVSMLACE       (0x0080)
+#define SVSLRVL0       (0x0100)
+#define SVSLRVL_0      (0x0000)
+#define SVSLE          (0x0400)
+#define SVSLFP         (0x0800)
+#define SVMLE          (0x4000)
+#define SVMLFP         (0x8000)
+
+/* RTC_A */
+#define RTCAIFG        (0x0002)
+#define RTCAIE         (0x0020)
+#define RTCTEVIE       (0x0040)
+#define RTCRDYIE       (0x0080)
+#define RTCRDY         (0x1000)
+#define RTCSSEL_0      (0x0000)
+#define RTCSSEL__ACLK  (0x0000)
+#define RTCMODE        (0x2000)
+#define RTCHOLD        (0x4000)
+#define RTCBCD         (0x8000)
+#define RTC_A_AE       (0x80)
+
+/* USB */
+#define USBKEY         (0x9628)
+#define USB_EN         (0x80)
+#define UPLLEN         (0x0100)
+
+#endif
@@ -0,0 +1,285 @@
+/**
+ * @file replay.c
+ * @brief Host replay of a REC DUMP log through the unmodified firmware.
+ *
+ * Usage: replay <dump.txt> [extra_ticks]
+ *
+ * Reads the hex lines between REC BEGIN / REC END (a raw console capture
+ * is fine), boots the drivers with all stages run up front, then feeds
+ * each entry at its virtual time:
+ *   TICK n : n ticks (ticker ISR + scheduler_run, as in main's loop);
+ *            button samples logged in the last of them are applied to
+ *            P1IN first, since poll_button took them in that tick
+ *   UART   : UCA1RXBUF + USCI_A1_ISR()
+ *   ADC    : ADC12MEM0 + ADC12_interrupt()
+ * TB0R follows the logged dt, so timestamp_now() (latency, analyzer
+ * crossings) sees the recorded timing. extra_ticks (default 20) run
+ * after the log so the last inputs are handled.
+ *
+ * Console output goes to stdout; per-task host timing goes to stderr.
+ * Comparing both between firmware versions shows behaviour changes and
+ * relative task cost for the same field session.
+ */
+
+#include <msp430.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "record.h"
+#include "scheduler.h"
+#include "tasks.h"
+#include "ticker.h"
+#include "timestamp.h"
+#include "init.h"
+#include "led.h"
+#include "pwm.h"
+#include "button.h"
+#include "uart.h"
+#include "adc.h"
+#include "power.h"
+#include "mode.h"
+#include "fault.h"
+#include "stepper.h"
+#include "usbram.h"
+
+#define MAX_ENTRIES 65536
+#define MAX_TASKS 16
+#define DEFAULT_EXTRA_TICKS 20
+
+void USCI_A1_ISR(void);
+void ADC12_interrupt(void);
+void timerA1Elapsed(void);
+
+static record_entry_t entries[MAX_ENTRIES];
+static uint32_t num_entries = 0;
+static uint32_t vtime = 0;          /* virtual timestamp counts */
+static uint16_t ticks = 0;
+
+/* ---- boot: same drivers as main.c, nothing deferred ---- */
+
+static void console_init() {
+    uart_init();
+    power_acquire(PERIPH_USCI_A1);
+}
+
+static void duty_init() {
+    set_duty_from_adc(true);
+}
+
+static const init_stage_t host_stages[] = {
+    { "usbram", usbram_init,  0, false },
+    { "led",    led_init,     0, false },
+    { "pwm",    pwm_init,     0, false },
+    { "fault",  fault_init,   0, false },
+    { "stepper", stepper_init, 0, false },
+    { "button", button_init,  0, false },
+    { "ticker", ticker_init,  0, false },
+    { "uart",   console_init, 0, false },
+    { "adc",    adc_init,     0, false },
+    { "duty",   duty_init,    0, false },
+};
+
+/* Hardware flags the drivers busy-wait on read as already set */
+static void host_reset() {
+    UCA1IFG = UCTXIFG;
+    PMMIFG = SVSMLDLYIFG | SVMLVLRIFG | SVSMHDLYIFG | SVMHVLRIFG;
+    RTCCTL01 = RTCRDY;
+    P1IN = BIT1;                    /* button released (pull-up) */
+    P2IN = BIT0;                    /* fault line released (pull-up) */
+}
+
+/* ---- per-task host timing via one trampoline per table slot ---- */
+
+typedef struct {
+    task_fn_t fn;
+    uint32_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} task_timing_t;
+
+static task_t tasks[MAX_TASKS];
+static task_t *task_refs[MAX_TASKS];
+static task_timing_t timing[MAX_TASKS];
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void run_timed(uint8_t i, uint16_t g_ticks) {
+    uint64_t t0 = now_ns();
+    timing[i].fn(g_ticks);
+    uint64_t dt = now_ns() - t0;
+    ++timing[i].calls;
+    timing[i].total_ns += dt;
+    if (dt > timing[i].max_ns) {
+        timing[i].max_ns = dt;
+    }
+}
+
+#define TRAMPOLINE(i) static void trampoline##i(uint16_t t) { run_timed(i, t); }
+TRAMPOLINE(0)  TRAMPOLINE(1)  TRAMPOLINE(2)  TRAMPOLINE(3)
+TRAMPOLINE(4)  TRAMPOLINE(5)  TRAMPOLINE(6)  TRAMPOLINE(7)
+TRAMPOLINE(8)  TRAMPOLINE(9)  TRAMPOLINE(10) TRAMPOLINE(11)
+TRAMPOLINE(12) TRAMPOLINE(13) TRAMPOLINE(14) TRAMPOLINE(15)
+
+static const task_fn_t trampolines[MAX_TASKS] = {
+    trampoline0,  trampoline1,  trampoline2,  trampoline3,
+    trampoline4,  trampoline5,  trampoline6,  trampoline7,
+    trampoline8,  trampoline9,  trampoline10, trampoline11,
+    trampoline12, trampoline13, trampoline14, trampoline15,
+};
+
+static uint8_t wrap_tasks() {
+    uint8_t n = REGISTRY_COUNT(tasks);
+    if (n > MAX_TASKS) {
+        n = MAX_TASKS;
+    }
+    for (uint8_t i = 0; i < n; ++i) {
+        tasks[i] = *REGISTRY_START(tasks)[i];
+        timing[i].fn = tasks[i].fn;
+        tasks[i].fn = trampolines[i];
+        task_refs[i] = &tasks[i];
+    }
+    return n;
+}
+
+static void print_timing(uint8_t n) {
+    fprintf(stderr, "%-8s %8s %12s %10s %10s\n", "TASK", "CALLS", "TOTAL_NS", "AVG_NS", "MAX_NS");
+    for (uint8_t i = 0; i < n; ++i) {
+        uint64_t avg = timing[i].calls ? timing[i].total_ns / timing[i].calls : 0;
+        fprintf(stderr, "%-8s %8u %12llu %10llu %10llu\n", tasks[i].name,
+                (unsigned)timing[i].calls, (unsigned long long)timing[i].total_ns,
+                (unsigned long long)avg, (unsigned long long)timing[i].max_ns);
+    }
+}
+
+/* ---- log input ---- */
+
+static int load(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    char line[128];
+    int framed = 0;
+    while (fgets(line, sizeof line, f) && num_entries < MAX_ENTRIES) {
+        if (strncmp(line, "REC BEGIN", 9) == 0) {
+            framed = 1;
+            num_entries = 0;
+            continue;
+        }
+        if (strncmp(line, "REC END", 7) == 0) {
+            if (framed) {
+                break;
+            }
+            continue;
+        }
+        unsigned dt, word;
+        if (strlen(line) >= 8 && sscanf(line, "%4x%4x", &dt, &word) == 2) {
+            entries[num_entries].dt = (uint16_t)dt;
+            entries[num_entries].word = (uint16_t)word;
+            ++num_entries;
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+/* ---- replay ---- */
+
+static void tick() {
+    TB0R = (uint16_t)vtime;
+    timerA1Elapsed();
+    if (consume_tick()) {
+        scheduler_run(ticks);
+        ++ticks;
+        scheduler_apply_tick_change(ticks);
+        mode_apply_pending(ticks);
+    }
+}
+
+static void set_button(uint16_t value) {
+    P1IN = value ? (P1IN | BIT1) : (P1IN & ~BIT1);
+}
+
+/* Button samples logged between this TICK entry and the next one */
+static void apply_button_lookahead(uint32_t i) {
+    for (uint32_t j = i + 1; j < num_entries; ++j) {
+        uint16_t w = entries[j].word;
+        if (REC_SRC(w) == REC_SRC_TICK) {
+            break;
+        }
+        if (REC_SRC(w) == REC_SRC_BUTTON) {
+            set_button(REC_VALUE(w));
+        }
+    }
+}
+
+static void replay() {
+    for (uint32_t i = 0; i < num_entries; ++i) {
+        uint16_t w = entries[i].word;
+        uint16_t value = REC_VALUE(w);
+        vtime += entries[i].dt;
+        TB0R = (uint16_t)vtime;
+        switch (REC_SRC(w)) {
+        case REC_SRC_TICK:
+            for (uint16_t n = 1; n < value; ++n) {
+                tick();
+            }
+            apply_button_lookahead(i);
+            tick();
+            break;
+        case REC_SRC_UART:
+            UCA1RXBUF = value;
+            UCA1IV = 2;
+            USCI_A1_ISR();
+            break;
+        case REC_SRC_ADC:
+            ADC12MEM0 = value;
+            ADC12IV = ADC12IV_ADC12IFG0;
+            ADC12_interrupt();
+            break;
+        case REC_SRC_BUTTON:
+            set_button(value);      /* initial level; later ones via lookahead */
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <dump.txt> [extra_ticks]\n", argv[0]);
+        return 2;
+    }
+    if (load(argv[1]) != 0) {
+        return 1;
+    }
+    uint16_t extra = (argc > 2) ? (uint16_t)atoi(argv[2]) : DEFAULT_EXTRA_TICKS;
+
+    host_reset();
+    timestamp_init();
+    init_run(host_stages, (uint8_t)(sizeof(host_stages) / sizeof(host_stages[0])));
+    uint8_t n = wrap_tasks();
+    scheduler_init(task_refs, n);
+    mode_init();
+    ticker_on();
+    __enable_interrupt();
+
+    replay();
+    for (uint16_t k = 0; k < extra; ++k) {
+        vtime += (uint32_t)ticker_period_ms() * 1000;
+        tick();
+    }
+    host_uart_tx_flush();
+    fflush(stdout);
+
+    fprintf(stderr, "\n%lu entries, %u ticks\n", (unsigned long)num_entries, (unsigned)ticks);
+    print_timing(n);
+    return 0;
+}
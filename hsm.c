@@ -0,0 +1,91 @@
+/**
+ * @file hsm.c
+ * @brief Table-driven hierarchical state machine.
+ *
+ * States and transitions live in const tables (flash). Dispatch indexes
+ * transitions[state][event] directly; only when the entry is empty or
+ * its guard fails does it retry with the parent state, so the cost is
+ * O(1) per level and flat machines never walk. A transition exits from
+ * the current state up to the common ancestor with the target, runs the
+ * action, then enters down to the target (a self-transition exits and
+ * re-enters). Nesting is limited to HSM_MAX_DEPTH levels.
+ */
+
+#include "hsm.h"
+
+static uint8_t depth(const hsm_def_t *def, uint8_t s) {
+    uint8_t d = 0;
+    while (s != HSM_NONE) {
+        s = def->states[s].parent;
+        ++d;
+    }
+    return d;
+}
+
+static void run(hsm_action_t action, hsm_t *m) {
+    if (action) {
+        action(m);
+    }
+}
+
+static void transition(hsm_t *m, uint8_t source, uint8_t target, hsm_action_t action) {
+    const hsm_def_t *def = m->def;
+
+    /* Lowest common ancestor of the handling state and the target; for a
+     * self-transition the source's parent, so the source is re-entered. */
+    uint8_t a = source;
+    uint8_t b = target;
+    if (a == b) {
+        a = def->states[a].parent;
+        b = a;
+    }
+    uint8_t da = depth(def, a);
+    uint8_t db = depth(def, b);
+    while (da > db) { a = def->states[a].parent; --da; }
+    while (db > da) { b = def->states[b].parent; --db; }
+    while (a != b) {
+        a = def->states[a].parent;
+        b = def->states[b].parent;
+    }
+    uint8_t lca = a;
+
+    for (uint8_t s = m->state; s != lca; s = def->states[s].parent) {
+        run(def->states[s].exit, m);
+    }
+
+    run(action, m);
+
+    uint8_t path[HSM_MAX_DEPTH];
+    uint8_t n = 0;
+    for (uint8_t s = target; s != lca && n < HSM_MAX_DEPTH; s = def->states[s].parent) {
+        path[n++] = s;
+    }
+    m->state = target;
+    while (n > 0) {
+        run(def->states[path[--n]].entry, m);
+    }
+}
+
+void hsm_init(hsm_t *m, const hsm_def_t *def) {
+    m->def = def;
+    m->state = def->initial;
+    run(def->states[m->state].entry, m);
+}
+
+/* Returns true if some state (the current one or an ancestor) handled it */
+bool hsm_dispatch(hsm_t *m, uint8_t event) {
+    const hsm_def_t *def = m->def;
+    for (uint8_t s = m->state; s != HSM_NONE; s = def->states[s].parent) {
+        const hsm_transition_t *t = &def->transitions[s * def->num_events + event];
+        if (t->target == HSM_NONE || (t->guard && !t->guard(m))) {
+            continue;
+        }
+        if (t->target == HSM_INTERNAL) {
+            run(t->action, m);
+        } else {
+            transition(m, s, t->target, t->action);
+        }
+        return true;
+    }
+    return false;
+}
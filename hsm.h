@@ -0,0 +1,44 @@
+#ifndef HSM_H
+#define HSM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HSM_NONE 0xFF           /* no parent / no transition (bubble up) */
+#define HSM_INTERNAL 0xFE       /* run the action only, no exit/entry */
+#define HSM_MAX_DEPTH 4
+
+typedef struct hsm hsm_t;
+typedef void (*hsm_action_t)(hsm_t *);
+typedef bool (*hsm_guard_t)(const hsm_t *);
+
+typedef struct {
+    uint8_t parent;             /* HSM_NONE for a top-level state */
+    hsm_action_t entry;         /* optional */
+    hsm_action_t exit;          /* optional */
+} hsm_state_t;
+
+typedef struct {
+    uint8_t target;             /* state index, HSM_INTERNAL or HSM_NONE */
+    hsm_guard_t guard;          /* optional; false => try the parent state */
+    hsm_action_t action;        /* optional; runs between exits and entries */
+} hsm_transition_t;
+
+/* Flash-resident machine: transitions[state * num_events + event] */
+typedef struct {
+    const hsm_state_t *states;
+    const hsm_transition_t *transitions;
+    uint8_t num_states;
+    uint8_t num_events;
+    uint8_t initial;
+} hsm_def_t;
+
+struct hsm {
+    const hsm_def_t *def;
+    uint8_t state;
+};
+
+void hsm_init(hsm_t *m, const hsm_def_t *def);
+bool hsm_dispatch(hsm_t *m, uint8_t event);
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * @file init.c
+ * @brief Dependency-ordered driver initialization with boot-stage timestamps.
+ *
+ * init_run() is called from main() right after the timestamp timer is
+ * started and runs every non-deferred stage in dependency order. Deferred
+ * stages (console, ADC, ...) are run one per call of init_step() from a
+ * scheduler task, so outputs are driven before the first tick and slow
+ * drivers never hold up boot. Times are timestamp counts (~1 us) since
+ * init_run() was entered, so they are valid while boot completes within
+ * one timer wrap (~65 ms); C startup before main() is not included.
+ */
+
+#include "init.h"
+#include "timestamp.h"
+#include "ticker.h"
+#include "uart.h"
+
+static const init_stage_t * stages = 0;
+static uint8_t num_of_stages = 0;
+static uint16_t done_mask = 0;
+static uint16_t boot_stamp = 0;
+static uint16_t first_tick = 0;          /* boot -> first tick task run */
+static uint16_t stage_start[INIT_MAX_STAGES];
+static uint16_t stage_duration[INIT_MAX_STAGES];
+
+static bool runnable(uint8_t i, bool deferred) {
+    return !(done_mask & INIT_DEP(i))
+        && stages[i].deferred == deferred
+        && (stages[i].deps & ~done_mask) == 0;
+}
+
+static void run_stage(uint8_t i) {
+    uint16_t t0 = timestamp_now();
+    stages[i].fn();
+    stage_duration[i] = (uint16_t)(timestamp_now() - t0);
+    stage_start[i] = (uint16_t)(t0 - boot_stamp);
+    done_mask |= INIT_DEP(i);
+}
+
+/* Run all critical stages; repeat passes until no further stage can run */
+void init_run(const init_stage_t arr[], uint8_t count) {
+    boot_stamp = timestamp_now();
+    stages = arr;
+    num_of_stages = (count > INIT_MAX_STAGES) ? INIT_MAX_STAGES : count;
+
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (uint8_t i = 0; i < num_of_stages; ++i) {
+            if (runnable(i, false)) {
+                run_stage(i);
+                progress = true;
+            }
+        }
+    }
+}
+
+/*
+ * Background slice: run at most one deferred stage. Returns true once
+ * every stage is done; the boot report is printed when the last one
+ * completes.
+ */
+bool init_step() {
+    uint16_t all = (uint16_t)((1UL << num_of_stages) - 1);
+    if (done_mask == all) {
+        return true;
+    }
+    if (first_tick == 0) {
+        first_tick = (uint16_t)(ticker_last_stamp() - boot_stamp);
+    }
+    for (uint8_t i = 0; i < num_of_stages; ++i) {
+        if (runnable(i, true)) {
+            run_stage(i);
+            break;
+        }
+    }
+    if (done_mask == all) {
+        init_report();
+        return true;
+    }
+    return false;
+}
+
+bool init_finished() {
+    return num_of_stages > 0 && done_mask == (uint16_t)((1UL << num_of_stages) - 1);
+}
+
+bool init_done(uint8_t stage) {
+    return (done_mask & INIT_DEP(stage)) != 0;
+}
+
+void init_report() {
+    uart_puts("\nBOOT STAGE START US\n");
+    for (uint8_t i = 0; i < num_of_stages; ++i) {
+        uart_puts(stages[i].name);
+        uart_puts(stages[i].deferred ? " D " : " C ");
+        if (!init_done(i)) {
+            uart_puts("PENDING\n");
+            continue;
+        }
+        uart_put_uint16(stage_start[i]);
+        uart_putc(' ');
+        uart_put_uint16(stage_duration[i]);
+        uart_putc('\n');
+    }
+    uart_puts("first tick ");
+    uart_put_uint16(first_tick);
+    uart_putc('\n');
+}
@@ -0,0 +1,25 @@
+#ifndef INIT_H
+#define INIT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define INIT_MAX_STAGES 16
+#define INIT_DEP(stage) ((uint16_t)(1U << (stage)))
+
+typedef void (*init_fn_t)(void);
+
+typedef struct {
+    const char *name;
+    init_fn_t fn;
+    uint16_t deps;      /* INIT_DEP() mask of stages that must run first */
+    bool deferred;      /* run in a background slice after the first tick */
+} init_stage_t;
+
+void init_run(const init_stage_t stages[], uint8_t count);
+bool init_step();
+bool init_done(uint8_t stage);
+bool init_finished();
+void init_report();
+
+#endif
@@ -9,41 +9,101 @@
 #include "ticker.h"
 #include "tasks.h"
 #include "led.h"
+#include "timestamp.h"
+#include "init.h"
+#include "flash_crc.h"
+#include "power.h"
+#include "rtc.h"
+#include "nest.h"
+#include "mode.h"
+#include "fault.h"
+#include "stepper.h"
+#include "usbram.h"
 
 
 #define MAX_TICK_PERIOD 32767
 
 
-static  task_t tasks[] = {  
-    {
-        .fn = poll_button,
-        .period_ticks = 1,
-        .next_run = 0,
-    },
-    
-     {
-        .fn = poll_adc,
-        .period_ticks = 5,
-        .next_run = 0
-    },
-    
-     {
-        .fn = poll_uart_rx,
-        .period_ticks = 5,
-        .next_run = 0
-    } 
+/* Console client: holds USCI_A1 for command input */
+static void console_init() {
+    uart_init();
+    power_acquire(PERIPH_USCI_A1);
+}
+
+/* Default duty source is the ADC (holds the ADC12 client) */
+static void duty_init() {
+    set_duty_from_adc(true);
+}
+
+enum {
+    STAGE_USBRAM,
+    STAGE_LED,
+    STAGE_PWM,
+    STAGE_FAULT,
+    STAGE_STEPPER,
+    STAGE_BUTTON,
+    STAGE_TICKER,
+    STAGE_UART,
+    STAGE_ADC,
+    STAGE_DUTY,
+    STAGE_FLASH_CRC,
+    STAGE_RTC
+};
+
+/* Outputs and the tick come up before the first tick; console and ADC
+ * are deferred to background slices run by poll_init. */
+static const init_stage_t init_stages[] = {
+    [STAGE_USBRAM] = { "usbram", usbram_init, 0,                    false },
+    [STAGE_LED]    = { "led",    led_init,    0,                    false },
+    [STAGE_PWM]    = { "pwm",    pwm_init,    0,                    false },
+    [STAGE_FAULT]  = { "fault",  fault_init,  INIT_DEP(STAGE_PWM),  false },
+    [STAGE_STEPPER] = { "stepper", stepper_init, INIT_DEP(STAGE_FAULT), false },
+    [STAGE_BUTTON] = { "button", button_init, 0,                    false },
+    [STAGE_TICKER] = { "ticker", ticker_init, 0,                    false },
+    [STAGE_UART]   = { "uart",   console_init, 0,                   true  },
+    [STAGE_ADC]    = { "adc",    adc_init,    INIT_DEP(STAGE_PWM) | INIT_DEP(STAGE_USBRAM), true },
+    [STAGE_DUTY]   = { "duty",   duty_init,   INIT_DEP(STAGE_ADC) | INIT_DEP(STAGE_FAULT), true },
+    [STAGE_FLASH_CRC] = { "crc", flash_crc_init, INIT_DEP(STAGE_TICKER), true },
+    [STAGE_RTC]    = { "rtc",    rtc_init,    0,                    true  },
 };
 
-#define NUM_TASKS ((uint8_t)(sizeof(tasks) / sizeof(tasks[0])))
+#define NUM_INIT_STAGES ((uint8_t)(sizeof(init_stages) / sizeof(init_stages[0])))
+
+
+/*
+ * Standby: stop the tick, let the console go, and sleep (LPM3 unless the
+ * ADC is still in use) until the RTC alarm ISR wakes us. The alarm event
+ * is left for poll_rtc to run the scheduled job once the tick is back.
+ * The console client is only dropped (and retaken) if the mode has not
+ * already dropped it; the mode keeps owning its own release.
+ */
+static void standby() {
+    bool console = !mode_console_off();
+    ticker_off();
+    if (console) {
+        power_release(PERIPH_USCI_A1);
+    }
+    while (1) {
+        __disable_interrupt();
+        if (rtc_alarm_pending()) {
+            __enable_interrupt();
+            break;
+        }
+        __bis_SR_register(power_sleep_bits() | GIE);   // GIE + LPM set atomically
+    }
+    if (console) {
+        power_acquire(PERIPH_USCI_A1);
+    }
+    ticker_on();
+}
 
 void main() {
     WDTCTL = WDTPW | WDTHOLD;   
-    adc_init();
-    button_init();
-    led_init();     //onboard leds
-    pwm_init();
-     uart_init();
-    ticker_init();
+    nest_init();
+    timestamp_init();
+    init_run(init_stages,NUM_INIT_STAGES);
+    scheduler_init(REGISTRY_START(tasks),REGISTRY_COUNT(tasks));
+    mode_init();
     ticker_on();
     __bis_SR_register(GIE);  // Enable global interrupts
 
@@ -52,10 +112,21 @@ void main() {
     uint16_t ticks = 0; //wraparound at 65535
     
     while(1) {
-            __bis_SR_register(LPM0_bits | GIE);   // sleep until  ticker ISR it  wakes up    
+            // LPM0 during boot keeps the timestamp running for the boot report;
+            // afterwards LPM3 whenever no peripheral needs SMCLK
+            uint16_t sleep_bits = init_finished() ? power_sleep_bits() : LPM0_bits;
+            __bis_SR_register(sleep_bits | GIE);   // sleep until ticker ISR wakes up    
             if(consume_tick()) {
-            scheduler_run(tasks,NUM_TASKS,ticks);
+            scheduler_run(ticks);
             ++ticks; 
+            scheduler_apply_tick_change(ticks);     // TICK <ms> lands between ticks
+            mode_apply_pending(ticks);              // so does MODE <name>
+            if (init_done(STAGE_FLASH_CRC) && mode_scrub_on()) {
+                flash_crc_idle();   // idle-time scrub slice, skipped if a tick is pending
+            }
+            if (consume_standby_request()) {
+                standby();
+            }
         }
     }
 }
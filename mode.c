@@ -0,0 +1,230 @@
+/**
+ * @file mode.c
+ * @brief Operating modes: task set, tick, clock and peripheral profiles.
+ *
+ * Each mode is a const profile. The modes are children of one RUN state
+ * in an HSM (hsm.c): RUN handles "go to mode X" for every mode, and each
+ * mode swallows the request for itself. Entering a mode applies its
+ * profile; leaving it undoes exactly what it took (boost client, console
+ * client, ADC clock, stream, recording), so any mode-to-mode switch is
+ * exit(old) + enter(new) and modes never need to know about each other.
+ *
+ *   NORMAL  5 ms tick, all tasks
+ *   ECO     50 ms tick, no console/stream/scrub tasks, ADC on ACLK and
+ *           the console released, so the main loop can sleep in LPM3;
+ *           a long press returns to NORMAL
+ *   PERF    1 ms tick, clock boosted
+ *   DIAG    5 ms tick, ADC stream (/16) and input recording on
+ *
+ * Requests (MODE command, long press) are queued and applied by the
+ * main loop between ticks; the time each switch takes is recorded.
+ */
+
+#include "mode.h"
+#include <string.h>
+#include "hsm.h"
+#include "scheduler.h"
+#include "tasks.h"
+#include "ticker.h"
+#include "timestamp.h"
+#include "clock.h"
+#include "power.h"
+#include "adc.h"
+#include "record.h"
+#include "uart.h"
+
+#define MODE_STREAM_DECIMATE 16
+
+typedef struct {
+    const char *name;
+    uint16_t tick_ms;
+    uint16_t tasks;             /* TASK_BIT() mask */
+    bool boost;                 /* hold a clock boost client */
+    bool console_off;           /* drop the console's USCI_A1 client */
+    bool adc_slow;              /* ADC12 from ACLK */
+    uint16_t stream;            /* ADC stream decimation, 0 = off */
+    bool trace;                 /* record inputs (REC ON) */
+} mode_profile_t;
+
+static const mode_profile_t profiles[MODE_COUNT] = {
+    [MODE_NORMAL] = { "NORMAL", 5,  TASK_ALL, false, false, false, 0, false },
+    [MODE_ECO]    = { "ECO",    50,
+                      TASK_BIT(TASK_INIT) | TASK_BIT(TASK_BUTTON) | TASK_BIT(TASK_ADC) | TASK_BIT(TASK_RTC),
+                      false, true, true, 0, false },
+    [MODE_PERF]   = { "PERF",   1,  TASK_ALL, true,  false, false, 0, false },
+    [MODE_DIAG]   = { "DIAG",   5,  TASK_ALL, false, false, false, MODE_STREAM_DECIMATE, true },
+};
+
+/* HSM: the modes share the RUN superstate */
+#define ST_RUN MODE_COUNT
+#define NUM_STATES (MODE_COUNT + 1)
+
+/* Events 0..MODE_COUNT-1 request that mode */
+#define EV_GESTURE MODE_COUNT
+#define NUM_EVENTS (MODE_COUNT + 1)
+
+static hsm_t mode_hsm;
+static uint16_t apply_now;              /* tick the pending switch lands on */
+static bool owns_stream = false;
+static volatile uint8_t pending_event = HSM_NONE;
+static uint16_t last_switch = 0;        /* timestamp counts */
+static uint16_t max_switch = 0;
+static uint16_t switches = 0;
+
+static void enter_mode(hsm_t *m) {
+    const mode_profile_t *p = &profiles[m->state];
+    if (p->boost) {
+        clock_boost_acquire();
+    }
+    if (p->console_off) {
+        power_release(PERIPH_USCI_A1);
+    }
+    adc_set_slow(p->adc_slow);
+    if (p->stream && adc_stream_decimation() == 0) {
+        power_acquire(PERIPH_ADC12);
+        adc_stream_enable(p->stream);
+        owns_stream = true;
+    }
+    if (p->trace) {
+        record_start(false);
+    }
+    scheduler_set_task_mask(p->tasks, apply_now);
+    if (p->tick_ms != ticker_period_ms()) {
+        scheduler_request_tick_ms(p->tick_ms);
+        scheduler_apply_tick_change(apply_now);
+    }
+}
+
+static void exit_mode(hsm_t *m) {
+    const mode_profile_t *p = &profiles[m->state];
+    if (p->trace) {
+        record_stop();
+    }
+    if (owns_stream) {
+        adc_stream_enable(0);
+        power_release(PERIPH_ADC12);
+        owns_stream = false;
+    }
+    if (p->adc_slow) {
+        adc_set_slow(false);
+    }
+    if (p->console_off) {
+        power_acquire(PERIPH_USCI_A1);
+    }
+    if (p->boost) {
+        clock_boost_release();
+    }
+}
+
+#define MODE_STATE { ST_RUN, enter_mode, exit_mode }
+
+static const hsm_state_t mode_states[NUM_STATES] = {
+    [MODE_NORMAL] = MODE_STATE,
+    [MODE_ECO]    = MODE_STATE,
+    [MODE_PERF]   = MODE_STATE,
+    [MODE_DIAG]   = MODE_STATE,
+    [ST_RUN]      = { HSM_NONE, 0, 0 },
+};
+
+#define NO_TRANSITION { HSM_NONE, 0, 0 }
+#define STAY { HSM_INTERNAL, 0, 0 }
+#define GO(mode) { (mode), 0, 0 }
+
+static const hsm_transition_t mode_transitions[NUM_STATES][NUM_EVENTS] = {
+    [MODE_NORMAL] = { [MODE_NORMAL] = STAY, [MODE_ECO] = NO_TRANSITION, [MODE_PERF] = NO_TRANSITION,
+                      [MODE_DIAG] = NO_TRANSITION, [EV_GESTURE] = NO_TRANSITION },
+    [MODE_ECO]    = { [MODE_NORMAL] = NO_TRANSITION, [MODE_ECO] = STAY, [MODE_PERF] = NO_TRANSITION,
+                      [MODE_DIAG] = NO_TRANSITION, [EV_GESTURE] = GO(MODE_NORMAL) },
+    [MODE_PERF]   = { [MODE_NORMAL] = NO_TRANSITION, [MODE_ECO] = NO_TRANSITION, [MODE_PERF] = STAY,
+                      [MODE_DIAG] = NO_TRANSITION, [EV_GESTURE] = NO_TRANSITION },
+    [MODE_DIAG]   = { [MODE_NORMAL] = NO_TRANSITION, [MODE_ECO] = NO_TRANSITION, [MODE_PERF] = NO_TRANSITION,
+                      [MODE_DIAG] = STAY, [EV_GESTURE] = NO_TRANSITION },
+    [ST_RUN]      = { [MODE_NORMAL] = GO(MODE_NORMAL), [MODE_ECO] = GO(MODE_ECO), [MODE_PERF] = GO(MODE_PERF),
+                      [MODE_DIAG] = GO(MODE_DIAG), [EV_GESTURE] = NO_TRANSITION },
+};
+
+static const hsm_def_t mode_def = {
+    .states = mode_states,
+    .transitions = &mode_transitions[0][0],
+    .num_states = NUM_STATES,
+    .num_events = NUM_EVENTS,
+    .initial = MODE_NORMAL,
+};
+
+/* After scheduler_init(): enters NORMAL, which matches the boot setup */
+void mode_init() {
+    apply_now = 0;
+    hsm_init(&mode_hsm, &mode_def);
+}
+
+void mode_request(op_mode_t mode) {
+    if (mode < MODE_COUNT) {
+        pending_event = (uint8_t)mode;
+    }
+}
+
+/* Long press: leaves ECO; ignored by the other modes */
+void mode_gesture() {
+    pending_event = EV_GESTURE;
+}
+
+/* Main loop, between ticks: run the queued switch and time it */
+void mode_apply_pending(uint16_t now) {
+    uint8_t ev = pending_event;
+    if (ev == HSM_NONE) {
+        return;
+    }
+    pending_event = HSM_NONE;
+    uint8_t before = mode_hsm.state;
+    apply_now = now;
+    uint16_t t0 = timestamp_now();
+    hsm_dispatch(&mode_hsm, ev);
+    if (mode_hsm.state == before) {
+        return;
+    }
+    last_switch = (uint16_t)(timestamp_now() - t0);
+    if (last_switch > max_switch) {
+        max_switch = last_switch;
+    }
+    if (switches < UINT16_MAX) {
+        ++switches;
+    }
+}
+
+op_mode_t mode_current() {
+    return (op_mode_t)mode_hsm.state;
+}
+
+/* True while the current mode has dropped the console's USCI_A1 client */
+bool mode_console_off() {
+    return profiles[mode_hsm.state].console_off;
+}
+
+/* True if the current mode runs TASK_CRC; the idle scrub follows it */
+bool mode_scrub_on() {
+    return (profiles[mode_hsm.state].tasks & TASK_BIT(TASK_CRC)) != 0;
+}
+
+/* MODE_COUNT if no mode has that name */
+op_mode_t mode_from_name(const char *name) {
+    for (uint8_t i = 0; i < MODE_COUNT; ++i) {
+        if (strcmp(name, profiles[i].name) == 0) {
+            return (op_mode_t)i;
+        }
+    }
+    return MODE_COUNT;
+}
+
+void mode_report() {
+    uart_puts("\nMODE ");
+    uart_puts(profiles[mode_current()].name);
+    uart_puts(" TICK ");
+    uart_put_uint16(ticker_period_ms());
+    uart_puts(" SWITCHES ");
+    uart_put_uint16(switches);
+    uart_puts(" LAST_US ");
+    uart_put_uint16(last_switch);
+    uart_puts(" MAX_US ");
+    uart_put_uint16(max_switch);
+    uart_putc('\n');
+}
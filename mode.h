@@ -0,0 +1,25 @@
+#ifndef MODE_H
+#define MODE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    MODE_NORMAL,
+    MODE_ECO,
+    MODE_PERF,
+    MODE_DIAG,
+    MODE_COUNT
+} op_mode_t;
+
+void mode_init();
+void mode_request(op_mode_t mode);
+void mode_gesture();
+void mode_apply_pending(uint16_t now);
+op_mode_t mode_current();
+bool mode_console_off();
+bool mode_scrub_on();
+op_mode_t mode_from_name(const char *name);
+void mode_report();
+
+#endif
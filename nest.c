@@ -0,0 +1,101 @@
+/**
+ * @file nest.c
+ * @brief Depth-limited ISR nesting with stack low-water tracking.
+ *
+ * Only ISRs that opt in with nest_begin() run with GIE set, each with
+ * its own enable bit cleared, so an ISR can never preempt itself. The
+ * nesting depth is capped at NEST_MAX_DEPTH: past that the body simply
+ * runs with GIE clear, which bounds worst-case stack use at
+ * (depth + 1) ISR frames on top of main.
+ *
+ * A waking ISR that preempts a nested body clears the LPM bits in that
+ * ISR's frame, not main's; nest_wake() records it so nest_end() can tell
+ * the nested ISR to repeat the wake on its own exit.
+ *
+ * The stack low-water mark is sampled on nest_begin() and in the tick
+ * ISR, the innermost frame whenever it preempts a nested ISR. Usage is
+ * relative to the SP seen by nest_init() at the top of main().
+ */
+
+#include "nest.h"
+#include <msp430.h>
+#include "uart.h"
+#include "ticker.h"
+
+#define NEST_MAX_DEPTH 2
+
+static uint16_t stack_top = 0;
+static uint16_t stack_low = 0xFFFF;
+static volatile uint8_t depth = 0;
+static uint8_t max_depth = 0;
+static bool wake_pending = false;           /* a wake landed in a nested frame */
+
+/* Call first in main(): SP here is the reference for stack usage */
+void nest_init() {
+    stack_top = __get_SP_register();
+    stack_low = stack_top;
+}
+
+void nest_note_stack() {
+    uint16_t sp = __get_SP_register();
+    if (sp < stack_low) {
+        stack_low = sp;
+    }
+}
+
+/* In the ISR, after the source is acknowledged and with GIE still clear */
+bool nest_begin(volatile uint16_t *ie, uint16_t bit) {
+    nest_note_stack();
+    if (depth >= NEST_MAX_DEPTH) {
+        return false;
+    }
+    *ie &= ~bit;
+    if (++depth > max_depth) {
+        max_depth = depth;
+    }
+    __enable_interrupt();
+    return true;
+}
+
+/*
+ * Leaves GIE clear; the ISR return restores the interrupted context. True
+ * when a waking ISR preempted the body: the caller must then clear the
+ * LPM bits on its own exit so the wake reaches main.
+ */
+bool nest_end(volatile uint16_t *ie, uint16_t bit, bool nested) {
+    if (!nested) {
+        return false;
+    }
+    __disable_interrupt();
+    bool wake = wake_pending;
+    if (--depth == 0) {
+        wake_pending = false;
+    }
+    *ie |= bit;
+    return wake;
+}
+
+/* Called by every ISR that wakes main, next to its __bic_SR_register_on_exit() */
+void nest_wake() {
+    if (depth) {
+        wake_pending = true;
+    }
+}
+
+void nest_clear() {
+    __disable_interrupt();
+    stack_low = __get_SP_register();
+    max_depth = depth;
+    __enable_interrupt();
+}
+
+/* LOG STK: nesting depth, stack peak (bytes below main's SP), tick lag */
+void nest_report() {
+    uart_puts("\nSTK depth max ");
+    uart_put_uint16(max_depth);
+    uart_puts(" peak ");
+    uart_put_uint16((uint16_t)(stack_top - stack_low));
+    uart_puts(" B tick lag max ");
+    uart_put_uint16(ticker_max_lag());
+    uart_puts(" aclk\n");
+}
@@ -0,0 +1,21 @@
+#ifndef NEST_H
+#define NEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Selective ISR nesting. A long ISR acknowledges its source, then calls
+ * nest_begin() to mask that source (no re-entry) and set GIE so the
+ * tick can preempt the rest of its body; nest_end() restores both and
+ * reports a wake that a preempting ISR (nest_wake()) left in its frame.
+ */
+void nest_init();
+bool nest_begin(volatile uint16_t *ie, uint16_t bit);
+bool nest_end(volatile uint16_t *ie, uint16_t bit, bool nested);
+void nest_wake();
+void nest_note_stack();
+void nest_clear();
+void nest_report();
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * @file param.c
+ * @brief Flash-resident table of runtime tunables for GET/SET.
+ *
+ * Each entry names a variable owned by another module, with its type,
+ * accepted range and an optional callback run after a change. Modules
+ * add entries with REGISTER_PARAM(); the linker sorts them by name into
+ * one const array, so lookup is a binary search over flash.
+ */
+
+#include "param.h"
+#include <string.h>
+
+REGISTRY_TABLE(param_t, params);
+
+const param_t *param_find(const char *name) {
+    uint8_t lo = 0;
+    uint8_t hi = REGISTRY_COUNT(params);
+    while (lo < hi) {
+        uint8_t mid = (uint8_t)((lo + hi) / 2);
+        int c = strcmp(name, REGISTRY_START(params)[mid].name);
+        if (c == 0) {
+            return &REGISTRY_START(params)[mid];
+        }
+        if (c < 0) {
+            hi = mid;
+        } else {
+            lo = (uint8_t)(mid + 1);
+        }
+    }
+    return 0;
+}
+
+const param_t *param_at(uint8_t index) {
+    return (index < REGISTRY_COUNT(params)) ? &REGISTRY_START(params)[index] : 0;
+}
+
+uint8_t param_count() {
+    return REGISTRY_COUNT(params);
+}
+
+uint16_t param_get(const param_t *p) {
+    if (p->type == PARAM_U8) {
+        return *(volatile uint8_t *)p->ptr;
+    }
+    return *(volatile uint16_t *)p->ptr;    /* single 16-bit access */
+}
+
+/* false if value is outside [min, max]; the stored value is unchanged */
+bool param_set(const param_t *p, uint16_t value) {
+    if (value < p->min || value > p->max) {
+        return false;
+    }
+    if (p->type == PARAM_U8) {
+        *(volatile uint8_t *)p->ptr = (uint8_t)value;
+    } else {
+        *(volatile uint16_t *)p->ptr = value;
+    }
+    if (p->changed) {
+        p->changed();
+    }
+    return true;
+}
@@ -0,0 +1,35 @@
+#ifndef PARAM_H
+#define PARAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "registry.h"
+
+typedef enum {
+    PARAM_U8,
+    PARAM_U16
+} param_type_t;
+
+typedef void (*param_changed_t)();
+
+typedef struct {
+    const char *name;           /* upper case, at most 9 characters */
+    param_type_t type;
+    uint16_t min;
+    uint16_t max;
+    volatile void *ptr;         /* storage, owned by the tuned module */
+    param_changed_t changed;    /* run after a SET, may be NULL */
+} param_t;
+
+/* Register var (a uint8_t or uint16_t) as a GET/SET parameter */
+#define REGISTER_PARAM(name, type, min, max, var, changed) \
+    static const param_t REGISTRY_CAT(param_reg_, var) REGISTRY_ENTRY(param_t, params, name) = \
+        { name, type, min, max, &var, changed }
+
+const param_t *param_find(const char *name);
+const param_t *param_at(uint8_t index);
+uint8_t param_count();
+uint16_t param_get(const param_t *p);
+bool param_set(const param_t *p, uint16_t value);
+
+#endif
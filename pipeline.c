@@ -0,0 +1,121 @@
+/**
+ * @file pipeline.c
+ * @brief Static dataflow pipelines: source -> filter/map -> sink stages.
+ *
+ * A pipeline is a const graph: stages with typed input/output ports and
+ * edges between them. Each stage has at most one input, so a graph is a
+ * forest fanning out from its sources; an output may feed any number of
+ * stages. On the first run the graph is checked (port types match, every
+ * stage with an input port has exactly one edge into it, no cycles) and
+ * put in topological order; a rejected graph never runs and shows as BAD
+ * in LOG PIPE.
+ *
+ * Each run walks the stages in that order. A source always runs; any
+ * other stage runs only if its upstream stage produced a non-empty batch
+ * in this run. Values travel in batches of up to PIPE_BATCH, so a stage
+ * costs one call per batch rather than one per sample. Pipelines are
+ * scheduler tasks (REGISTER_PIPELINE), so task masks, latency histograms
+ * and tick changes apply to them unchanged.
+ */
+
+#include "pipeline.h"
+#include "uart.h"
+
+/* Kahn's algorithm over the single-input graph; false if it is invalid */
+static bool build(const pipeline_t *p) {
+    pipe_state_t *st = p->state;
+    uint8_t n = p->num_stages;
+    if (n > PIPE_MAX_STAGES) {
+        return false;
+    }
+    for (uint8_t s = 0; s < n; ++s) {
+        st->input[s] = PIPE_NO_INPUT;
+    }
+    for (uint8_t e = 0; e < p->num_edges; ++e) {
+        const pipe_edge_t *edge = &p->edges[e];
+        if (edge->from >= n || edge->to >= n) {
+            return false;
+        }
+        pipe_port_t type = p->stages[edge->from].out;
+        if (type == PIPE_NONE || type != p->stages[edge->to].in ||
+            st->input[edge->to] != PIPE_NO_INPUT) {
+            return false;
+        }
+        st->input[edge->to] = edge->from;
+    }
+
+    uint8_t placed = 0;
+    uint16_t done = 0;
+    while (placed < n) {
+        uint8_t before = placed;
+        for (uint8_t s = 0; s < n; ++s) {
+            if (done & (1u << s)) {
+                continue;
+            }
+            uint8_t in = st->input[s];
+            bool source = p->stages[s].in == PIPE_NONE;
+            if ((source && in == PIPE_NO_INPUT) || (!source && in != PIPE_NO_INPUT && (done & (1u << in)))) {
+                st->order[placed++] = s;
+                done |= (uint16_t)(1u << s);
+            }
+        }
+        if (placed == before) {
+            return false;           /* cycle or unconnected input */
+        }
+    }
+    return true;
+}
+
+void pipeline_run(const pipeline_t *p) {
+    pipe_state_t *st = p->state;
+    if (!st->built) {
+        st->built = true;
+        st->bad = !build(p);
+    }
+    if (st->bad) {
+        return;
+    }
+    for (uint8_t i = 0; i < p->num_stages; ++i) {
+        uint8_t s = st->order[i];
+        uint8_t in = st->input[s];
+        const pipe_batch_t *batch = (in == PIPE_NO_INPUT) ? 0 : &st->out[in];
+        st->out[s].n = 0;
+        if (batch && batch->n == 0) {
+            continue;
+        }
+        p->stages[s].fn(batch, &st->out[s]);
+        if (st->runs[s] < UINT16_MAX) {
+            ++st->runs[s];
+        }
+        if (batch) {
+            st->samples[s] += batch->n;     /* wraps; ratio to runs is the batch size */
+        }
+    }
+}
+
+/* LOG PIPE: stages in run order with call and input sample counts */
+void pipeline_report() {
+    uart_puts("\nPIPE STAGE IN RUNS SAMPLES\n");
+    for (uint8_t i = 0; i < REGISTRY_COUNT(pipes); ++i) {
+        const pipeline_t *p = REGISTRY_START(pipes)[i];
+        const pipe_state_t *st = p->state;
+        if (!st->built || st->bad) {
+            uart_puts(p->name);
+            uart_puts(st->bad ? " BAD\n" : " NOT RUN\n");
+            continue;
+        }
+        for (uint8_t k = 0; k < p->num_stages; ++k) {
+            uint8_t s = st->order[k];
+            uart_puts(p->name);
+            uart_putc(' ');
+            uart_puts(p->stages[s].name);
+            uart_putc(' ');
+            uart_puts(st->input[s] == PIPE_NO_INPUT ? "-" : p->stages[st->input[s]].name);
+            uart_putc(' ');
+            uart_put_uint16(st->runs[s]);
+            uart_putc(' ');
+            uart_put_uint16(st->samples[s]);
+            uart_putc('\n');
+        }
+    }
+}
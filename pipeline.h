@@ -0,0 +1,82 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "registry.h"
+#include "scheduler.h"
+
+#define PIPE_BATCH 8                /* samples per batch between stages */
+#define PIPE_MAX_STAGES 8
+
+/* Port types; an edge must connect an output and an input of one type */
+typedef enum {
+    PIPE_NONE,                      /* no port: source input, sink output */
+    PIPE_ADC12,                     /* ADC counts, 0..4095 */
+    PIPE_FRAC,                      /* unsigned fraction, 0x8000 = 1.0 */
+    PIPE_EVENT                      /* signed event code */
+} pipe_port_t;
+
+typedef struct {
+    uint8_t n;
+    uint16_t v[PIPE_BATCH];
+} pipe_batch_t;
+
+/*
+ * Stage body: consume in (NULL for a source), append up to PIPE_BATCH
+ * values to out (a sink leaves it empty). Runs only when a source or
+ * when its input batch is non-empty.
+ */
+typedef void (*pipe_fn_t)(const pipe_batch_t *in, pipe_batch_t *out);
+
+typedef struct {
+    const char *name;
+    pipe_port_t in;
+    pipe_port_t out;
+    pipe_fn_t fn;
+} pipe_stage_t;
+
+typedef struct {
+    uint8_t from;                   /* stage indices */
+    uint8_t to;
+} pipe_edge_t;
+
+/* Built on the first run: execution order and one batch per stage */
+typedef struct {
+    bool built;
+    bool bad;                       /* graph rejected, never runs */
+    uint8_t order[PIPE_MAX_STAGES];
+    uint8_t input[PIPE_MAX_STAGES]; /* upstream stage, or PIPE_NO_INPUT */
+    pipe_batch_t out[PIPE_MAX_STAGES];
+    uint16_t runs[PIPE_MAX_STAGES];
+    uint16_t samples[PIPE_MAX_STAGES];
+} pipe_state_t;
+
+typedef struct {
+    const char *name;
+    const pipe_stage_t *stages;
+    uint8_t num_stages;
+    const pipe_edge_t *edges;
+    uint8_t num_edges;
+    pipe_state_t *state;
+} pipeline_t;
+
+#define PIPE_NO_INPUT 0xFF
+
+/*
+ * Register a pipeline run by the scheduler every period_ms. key orders it
+ * among the tasks exactly like REGISTER_TASK; label shows in LOG LAT.
+ */
+#define REGISTER_PIPELINE(key, label, pipe, period) \
+    static void REGISTRY_CAT(pipe_run_, pipe)(uint16_t g_ticks) { pipeline_run(&pipe); } \
+    static task_t REGISTRY_CAT(pipe_task_, pipe) = { \
+        .name = label, .fn = REGISTRY_CAT(pipe_run_, pipe), .period_ms = period, .next_run = 0 }; \
+    REGISTER_TASK(key, REGISTRY_CAT(pipe_task_, pipe)); \
+    static const pipeline_t * const REGISTRY_CAT(pipe_reg_, pipe) REGISTRY_ENTRY(const pipeline_t *, pipes, key) = &pipe
+
+REGISTRY_TABLE(const pipeline_t *, pipes);
+
+void pipeline_run(const pipeline_t *p);
+void pipeline_report();
+
+#endif
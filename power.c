@@ -0,0 +1,103 @@
+/**
+ * @file power.c
+ * @brief Client reference counting for peripheral power gating.
+ *
+ * Drivers expose start/stop hooks; users call power_acquire() and
+ * power_release() around their use. The first client starts the
+ * peripheral, the last one stops it (module off, clock request dropped,
+ * pins parked). The start hook duration is recorded as the restart
+ * latency. With no SMCLK consumer left the main loop may sleep in LPM3
+ * instead of LPM0.
+ */
+
+#include <msp430.h>
+#include "power.h"
+#include "adc.h"
+#include "uart.h"
+#include "pwm.h"
+#include "stepper.h"
+#include "clock.h"
+#include "timestamp.h"
+
+typedef struct {
+    const char *name;
+    void (*start)(void);
+    void (*stop)(void);
+} periph_ops_t;
+
+typedef struct {
+    uint8_t clients;
+    uint16_t starts;
+    uint16_t last_start_us;
+    uint16_t max_start_us;
+} periph_state_t;
+
+static const periph_ops_t periph_ops[PERIPH_COUNT] = {
+    [PERIPH_ADC12]    = { "ADC12",   adc_start,  adc_stop  },
+    [PERIPH_USCI_A1]  = { "USCI_A1", uart_start, uart_stop },
+    [PERIPH_TIMER_A0] = { "TIMER_A0", pwm_start, pwm_stop  },
+    [PERIPH_TIMER_A2] = { "TIMER_A2", stepper_start, stepper_stop },
+};
+
+static periph_state_t periph_state[PERIPH_COUNT];
+
+void power_acquire(periph_t p) {
+    periph_state_t * st = &periph_state[p];
+    if (st->clients++ > 0) {
+        return;
+    }
+    uint16_t t0 = timestamp_now();
+    periph_ops[p].start();
+    st->last_start_us = (uint16_t)(timestamp_now() - t0);
+    if (st->last_start_us > st->max_start_us) {
+        st->max_start_us = st->last_start_us;
+    }
+    if (st->starts < UINT16_MAX) {
+        ++st->starts;
+    }
+}
+
+void power_release(periph_t p) {
+    periph_state_t * st = &periph_state[p];
+    if (st->clients == 0 || --st->clients > 0) {
+        return;
+    }
+    periph_ops[p].stop();
+}
+
+bool power_active(periph_t p) {
+    return periph_state[p].clients > 0;
+}
+
+/*
+ * LPM3 turns SMCLK and the DCO off: only allowed when no SMCLK user
+ * (ADC12 unless slowed to ACLK, USCI_A1, Timer_A2) is running and the clock is
+ * not boosted. Timer_A0
+ * and the ticker run from ACLK, which LPM3 keeps. The timestamp timer
+ * simply pauses while asleep.
+ */
+uint16_t power_sleep_bits() {
+    bool adc_smclk = power_active(PERIPH_ADC12) && adc_needs_smclk();
+    if (adc_smclk || power_active(PERIPH_USCI_A1) || power_active(PERIPH_TIMER_A2)
+        || clock_boosted()) {
+        return LPM0_bits;
+    }
+    return LPM3_bits;
+}
+
+void power_report() {
+    uart_puts("\nPERIPH CLIENTS STARTS LAST_US MAX_US\n");
+    for (uint8_t p = 0; p < PERIPH_COUNT; ++p) {
+        const periph_state_t * st = &periph_state[p];
+        uart_puts(periph_ops[p].name);
+        uart_putc(' ');
+        uart_put_uint16(st->clients);
+        uart_putc(' ');
+        uart_put_uint16(st->starts);
+        uart_putc(' ');
+        uart_put_uint16(st->last_start_us);
+        uart_putc(' ');
+        uart_put_uint16(st->max_start_us);
+        uart_putc('\n');
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    PERIPH_ADC12,
+    PERIPH_USCI_A1,
+    PERIPH_TIMER_A0,
+    PERIPH_TIMER_A2,
+    PERIPH_COUNT
+} periph_t;
+
+void power_acquire(periph_t);
+void power_release(periph_t);
+bool power_active(periph_t);
+uint16_t power_sleep_bits();
+void power_report();
+
+#endif
@@ -1,23 +1,32 @@
 /**
  * @file pwm.c
  * @brief PWM on P1.2 using Timer_A0 CCR1 (ACLK).
+ *
+ * A non-zero duty holds a PERIPH_TIMER_A0 client; at 0% the timer is
+ * stopped and P1.2 parked as a GPIO driven low. While a fault is latched
+ * (fault.c) the timer may run but P1.2 stays a GPIO.
  */
  
 #include <msp430.h>
 #include <stdint.h>
 #include <pwm.h>
+#include <stdbool.h>
+#include "power.h"
+#include "fault.h"
 #define TIMER_CCR0_VALUE ((uint16_t)320)
 
+static bool pwm_client = false;      /* true while duty > 0 holds Timer_A0 */
+
 
 /* Configure P1.2 as Timer_A0 CCR1 output */
 
 
 
-/* Initialize Timer_A0 for PWM on CCR1 */
+/* Initialize Timer_A0 for PWM on CCR1; left stopped with P1.2 parked low */
 void pwm_init(void)
 {   
      P1DIR |= BIT2;  /* P1.2 as output */
-    P1SEL |= BIT2;  /* P1.2 function select: TA0.1 (Timer_A CCR1 output) */
+    P1OUT &= ~BIT2; /* parked level while the timer is stopped */
 
     TA0CTL = TASSEL_1 | MC_0;           /* ACLK, stop */
     TA0CTL = (TA0CTL & ~ID_3) | ID_0;  /* /1 divider */
@@ -34,10 +43,46 @@ void pwm_init(void)
     TA0CCTL1 &= ~CCIE;                 /* no CCR1 IRQ */
 
     TA0CCR1 = 0;                      /* 0% duty */
+}
 
+void pwm_start(void)
+{
+    TA0CTL |= TACLR;
+    if (!fault_latched()) {
+        P1SEL |= BIT2;  /* P1.2 function select: TA0.1 (Timer_A CCR1 output) */
+    }
     TA0CTL |= MC__UP;                  /* up mode */
 }
 
+/* Fault cleared: restore reset/set and the pin if the timer is running */
+void pwm_fault_release(void)
+{
+    TA0CCTL1 = (TA0CCTL1 & ~OUTMOD_7) | OUTMOD_7;
+    if (TA0CTL & MC_3) {
+        P1SEL |= BIT2;
+    }
+}
+
+void pwm_stop(void)
+{
+    TA0CTL &= ~MC_3;                   /* stop: drops the ACLK request */
+    P1SEL &= ~BIT2;                    /* back to GPIO, driven low */
+}
+
+/* Load CCR1; a non-zero duty holds the Timer_A0 client */
+static void set_pwm_ccr(uint16_t ccr)
+{
+    TA0CCR1 = ccr;
+
+    if (ccr != 0 && !pwm_client) {
+        pwm_client = true;
+        power_acquire(PERIPH_TIMER_A0);
+    } else if (ccr == 0 && pwm_client) {
+        pwm_client = false;
+        power_release(PERIPH_TIMER_A0);
+    }
+}
+
 /* Set PWM duty cycle in [0.0, 1.0] */
 void set_pwm_duty_cycle(const float duty_cycle)
 {
@@ -46,8 +91,19 @@ void set_pwm_duty_cycle(const float duty_cycle)
     if (d < 0.0f) d = 0.0f;
     if (d > 1.0f) d = 1.0f;
 
-    TA0CCR1 = (uint16_t)(TIMER_CCR0_VALUE * d);
-}            
+    set_pwm_ccr((uint16_t)(TIMER_CCR0_VALUE * d));
+}
 
+/* Set PWM duty from a fraction with 0x8000 = 1.0 (no float) */
+void set_pwm_duty_frac(uint16_t frac)
+{
+    if (frac > 0x8000) frac = 0x8000;
 
+    set_pwm_ccr((uint16_t)(((uint32_t)TIMER_CCR0_VALUE * frac) >> 15));
+}
 
+/* Current duty in 0.1% steps (telemetry) */
+uint16_t pwm_duty_permille(void)
+{
+    return (uint16_t)(((uint32_t)TA0CCR1 * 1000UL + TIMER_CCR0_VALUE / 2) / TIMER_CCR0_VALUE);
+}
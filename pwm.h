@@ -1,8 +1,15 @@
 #ifndef PWM_H
 #define PWM_H
 
+#include <stdint.h>
+
 void pwm_init();
+void pwm_start();
+void pwm_stop();
+void pwm_fault_release();
 void set_pwm_duty_cycle(const float);
+void set_pwm_duty_frac(uint16_t frac);
+uint16_t pwm_duty_permille();
 
 
 #endif
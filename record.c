@@ -0,0 +1,127 @@
+/**
+ * @file record.c
+ * @brief Timestamped raw-input log for deterministic replay.
+ *
+ * While recording, every UART byte (USCI_A1_ISR), ADC sample
+ * (ADC12_interrupt, optional: ~7 k entries/s) and button sample change
+ * (button_debounce) is appended as a 4-byte entry. Ticks are counted
+ * and written as one TICK entry just before the next input, so idle
+ * time costs nothing and each input follows the tick it was seen in.
+ *
+ * The log is linear and stops when full: a replay must start from the
+ * state recording began in, so the oldest entries are never dropped.
+ * The current button level is logged first so replay starts in sync.
+ * host/replay.c reads the REC DUMP output back.
+ */
+
+#include "record.h"
+#include <msp430.h>
+#include "timestamp.h"
+#include "ticker.h"
+#include "usbram.h"
+
+#define RECORD_SIZE 256         /* entries (1 KB, in USB RAM) */
+#define TIMESTAMP_WRAP_MS 65    /* timestamp counter period */
+
+static record_entry_t entries[RECORD_SIZE] USBRAM;
+static uint16_t count = 0;
+static bool full = false;
+static uint16_t last_stamp = 0;     /* time of the newest entry */
+static uint16_t tick_stamp = 0;     /* time of the newest counted tick */
+static uint16_t pending_ticks = 0;  /* ticks not yet written */
+
+volatile uint8_t record_sources = 0;
+
+/* Append one entry; interrupts must be off */
+static bool put(uint16_t dt, uint8_t src, uint16_t value) {
+    if (count >= RECORD_SIZE) {
+        record_sources = 0;
+        full = true;
+        return false;
+    }
+    entries[count].dt = dt;
+    entries[count].word = (uint16_t)((uint16_t)src << 12) | (value & REC_VALUE_MASK);
+    ++count;
+    return true;
+}
+
+/* Write the ticks counted since the last TICK entry */
+static void flush_ticks() {
+    if (pending_ticks == 0) {
+        return;
+    }
+    bool wrapped = (uint32_t)pending_ticks * ticker_period_ms() > TIMESTAMP_WRAP_MS;
+    uint16_t dt = wrapped ? 0xFFFF : (uint16_t)(tick_stamp - last_stamp);
+    if (put(dt, REC_SRC_TICK, pending_ticks)) {
+        last_stamp = tick_stamp;
+        pending_ticks = 0;
+    }
+}
+
+/* Clear the log and record UART + button (+ ADC if adc) from now on */
+void record_start(bool adc) {
+    uint16_t state = __get_interrupt_state();
+    __disable_interrupt();
+    count = 0;
+    full = false;
+    pending_ticks = 0;
+    last_stamp = timestamp_now();
+    put(0, REC_SRC_BUTTON, (P1IN & BIT1) ? 1 : 0);
+    record_sources = (1u << REC_SRC_TICK) | (1u << REC_SRC_UART) | (1u << REC_SRC_BUTTON);
+    if (adc) {
+        record_sources |= (1u << REC_SRC_ADC);
+    }
+    __set_interrupt_state(state);
+}
+
+void record_stop() {
+    uint16_t state = __get_interrupt_state();
+    __disable_interrupt();
+    if (record_sources) {
+        flush_ticks();
+        record_sources = 0;
+    }
+    __set_interrupt_state(state);
+}
+
+bool record_active() {
+    return record_sources != 0;
+}
+
+bool record_full() {
+    return full;
+}
+
+uint16_t record_count() {
+    return count;
+}
+
+bool record_entry(uint16_t i, record_entry_t *entry) {
+    if (i >= count) {
+        return false;
+    }
+    *entry = entries[i];
+    return true;
+}
+
+/* Log one input now; callable from ISRs and from main */
+void record_input(uint8_t src, uint16_t value) {
+    uint16_t state = __get_interrupt_state();
+    __disable_interrupt();
+    if (record_sources & (1u << src)) {
+        uint16_t now = timestamp_now();
+        flush_ticks();
+        if (put((uint16_t)(now - last_stamp), src, value)) {
+            last_stamp = now;
+        }
+    }
+    __set_interrupt_state(state);
+}
+
+/* Count one tick (ticker ISR); written out before the next input */
+void record_tick(uint16_t stamp) {
+    tick_stamp = stamp;
+    if (++pending_ticks == REC_VALUE_MASK) {
+        flush_ticks();
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Raw input log entry: dt = timestamp counts (~1 us) since the previous
+ * entry, saturated at 0xFFFF; word = source << 12 | 12-bit value.
+ */
+typedef struct {
+    uint16_t dt;
+    uint16_t word;
+} record_entry_t;
+
+typedef enum {
+    REC_SRC_TICK   = 0,     /* value: ticks since the previous TICK entry */
+    REC_SRC_UART   = 1,     /* value: received byte */
+    REC_SRC_ADC    = 2,     /* value: ADC12MEM0 */
+    REC_SRC_BUTTON = 3      /* value: P1.1 raw sample (1 = released) */
+} record_src_t;
+
+#define REC_VALUE_MASK 0x0FFFu
+#define REC_SRC(word)   ((uint8_t)((word) >> 12))
+#define REC_VALUE(word) ((word) & REC_VALUE_MASK)
+
+/* Bit per source; zero when not recording (checked inline by the hooks) */
+extern volatile uint8_t record_sources;
+
+/* Input hooks: one test when recording is off */
+#define RECORD_INPUT(src, value) \
+    do { if (record_sources & (1u << (src))) record_input((src), (value)); } while (0)
+#define RECORD_TICK(stamp) \
+    do { if (record_sources) record_tick(stamp); } while (0)
+
+void record_start(bool adc);
+void record_stop();
+bool record_active();
+bool record_full();
+uint16_t record_count();
+bool record_entry(uint16_t i, record_entry_t *entry);
+void record_input(uint8_t src, uint16_t value);
+void record_tick(uint16_t stamp);
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+/*
+ * Link-time registration. REGISTRY_ENTRY(type, table, key) places one const
+ * descriptor in input section .reg_<table>.<key>; registry.ld collects
+ * every .reg_<table>.* section, sorted by key, into one contiguous flash
+ * array between __reg_<table>_start and __reg_<table>_end. A module
+ * registers itself by being linked; nothing central lists it.
+ */
+
+#define REGISTRY_CAT_(a, b) a##b
+#define REGISTRY_CAT(a, b) REGISTRY_CAT_(a, b)
+
+/* Explicit alignment: the compiler may otherwise over-align large
+ * objects, leaving gaps that break the array stride */
+#define REGISTRY_ENTRY(type, table, key) \
+    __attribute__((section(".reg_" #table "." key), used, aligned(__alignof__(type))))
+
+/* type is the element type; the array itself is const */
+#define REGISTRY_TABLE(type, table) \
+    extern type const __reg_##table##_start[]; \
+    extern type const __reg_##table##_end[]
+
+#define REGISTRY_START(table) (__reg_##table##_start)
+#define REGISTRY_COUNT(table) ((uint8_t)(__reg_##table##_end - __reg_##table##_start))
+
+#endif
@@ -0,0 +1,180 @@
+/**
+ * @file rtc.c
+ * @brief RTC_A calendar mode on ACLK with a daily alarm that wakes LPM3.
+ *
+ * The counter runs in binary (not BCD) calendar mode from the 32 kHz
+ * ACLK. rtc_init() starts XT1 on P5.4/P5.5 without waiting; until it is
+ * stable the UCS fail-safe keeps ACLK on REFO and clock_xt1_poll() keeps
+ * clearing the fault so ACLK moves to the crystal as soon as it can.
+ *
+ * The alarm matches hour and minute once a day. Its ISR exits any LPM
+ * so the main loop can leave standby (ticker stopped) for scheduled jobs.
+ */
+
+#include <msp430.h>
+#include "rtc.h"
+#include "clock.h"
+#include "uart.h"
+#include "nest.h"
+
+#define RTC_AE 0x80              /* alarm enable bit in RTCAxxx registers */
+#define RTC_EPOCH_YEAR 2000
+
+static volatile bool rtc_alarm_event = false;
+static bool standby_request = false;
+
+void rtc_init() {
+    clock_xt1_start();
+
+    RTCCTL01 = RTCMODE | RTCHOLD;     /* calendar mode, binary, held */
+    RTCYEAR = RTC_EPOCH_YEAR;
+    RTCMON = 1;
+    RTCDAY = 1;
+    RTCDOW = 6;                       /* 2000-01-01 was a Saturday */
+    RTCHOUR = 0;
+    RTCMIN = 0;
+    RTCSEC = 0;
+    RTCAMIN = 0;                      /* alarms disabled (AE = 0) */
+    RTCAHOUR = 0;
+    RTCADOW = 0;
+    RTCADAY = 0;
+    RTCCTL01 &= ~RTCHOLD;             /* start counting */
+}
+
+/* Wait for RTCRDY (safe read window), then copy the calendar registers */
+void rtc_get(rtc_time_t *t) {
+    while (!(RTCCTL01 & RTCRDY));
+    t->year = RTCYEAR;
+    t->month = RTCMON;
+    t->day = RTCDAY;
+    t->hour = RTCHOUR;
+    t->min = RTCMIN;
+    t->sec = RTCSEC;
+}
+
+void rtc_set_date(uint16_t year, uint8_t month, uint8_t day) {
+    RTCCTL01 |= RTCHOLD;
+    RTCYEAR = year;
+    RTCMON = month;
+    RTCDAY = day;
+    RTCCTL01 &= ~RTCHOLD;
+}
+
+void rtc_set_time(uint8_t hour, uint8_t min, uint8_t sec) {
+    RTCCTL01 |= RTCHOLD;
+    RTCHOUR = hour;
+    RTCMIN = min;
+    RTCSEC = sec;
+    RTCCTL01 &= ~RTCHOLD;
+}
+
+static bool leap(uint16_t year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+/* Seconds since 2000-01-01 00:00:00 */
+uint32_t rtc_timestamp() {
+    static const uint16_t days_before_month[12] = {
+        0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334
+    };
+    rtc_time_t t;
+    rtc_get(&t);
+
+    uint32_t days = 0;
+    for (uint16_t y = RTC_EPOCH_YEAR; y < t.year; ++y) {
+        days += leap(y) ? 366 : 365;
+    }
+    days += days_before_month[(t.month - 1) % 12];
+    if (t.month > 2 && leap(t.year)) {
+        ++days;
+    }
+    days += t.day - 1;
+    return ((days * 24 + t.hour) * 60 + t.min) * 60 + t.sec;
+}
+
+static void put_2digits(uint8_t v) {
+    uart_putc('0' + (v / 10) % 10);
+    uart_putc('0' + v % 10);
+}
+
+/* Print "YYYY-MM-DD HH:MM:SS" */
+void rtc_put_time() {
+    rtc_time_t t;
+    rtc_get(&t);
+    uart_put_uint16(t.year);
+    uart_putc('-');
+    put_2digits(t.month);
+    uart_putc('-');
+    put_2digits(t.day);
+    uart_putc(' ');
+    put_2digits(t.hour);
+    uart_putc(':');
+    put_2digits(t.min);
+    uart_putc(':');
+    put_2digits(t.sec);
+}
+
+/* Daily alarm at hour:min */
+void rtc_set_alarm(uint8_t hour, uint8_t min) {
+    RTCCTL01 &= ~(RTCAIE | RTCAIFG);
+    RTCAHOUR = hour | RTC_AE;
+    RTCAMIN = min | RTC_AE;
+    RTCADOW = 0;
+    RTCADAY = 0;
+    RTCCTL01 |= RTCAIE;
+}
+
+void rtc_clear_alarm() {
+    RTCCTL01 &= ~(RTCAIE | RTCAIFG);
+    RTCAHOUR = 0;
+    RTCAMIN = 0;
+    rtc_alarm_event = false;
+}
+
+bool rtc_alarm_enabled(uint8_t *hour, uint8_t *min) {
+    if (!(RTCCTL01 & RTCAIE)) {
+        return false;
+    }
+    *hour = RTCAHOUR & ~RTC_AE;
+    *min = RTCAMIN & ~RTC_AE;
+    return true;
+}
+
+bool rtc_alarm_pending() {
+    return rtc_alarm_event;
+}
+
+bool consume_rtc_alarm_event() {
+    if (rtc_alarm_event) {
+        rtc_alarm_event = false;
+        return true;
+    }
+    return false;
+}
+
+/* Ask the main loop to stop the tick and sleep until the next alarm */
+void rtc_request_standby() {
+    standby_request = true;
+}
+
+bool consume_standby_request() {
+    if (standby_request) {
+        standby_request = false;
+        return true;
+    }
+    return false;
+}
+
+/* RTC ISR: alarm match sets the event and wakes main from any LPM */
+#pragma vector=RTC_VECTOR
+__interrupt void RTC_ISR(void) {
+    switch (__even_in_range(RTCIV, 16)) {
+    case 6:                              /* RTCAIFG */
+        rtc_alarm_event = true;
+        nest_wake();
+        __bic_SR_register_on_exit(LPM3_bits);
+        break;
+    default:
+        break;
+    }
+}
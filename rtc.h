@@ -0,0 +1,32 @@
+#ifndef RTC_H
+#define RTC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+} rtc_time_t;
+
+void rtc_init();
+void rtc_get(rtc_time_t *);
+void rtc_set_date(uint16_t year, uint8_t month, uint8_t day);
+void rtc_set_time(uint8_t hour, uint8_t min, uint8_t sec);
+uint32_t rtc_timestamp();
+void rtc_put_time();
+
+void rtc_set_alarm(uint8_t hour, uint8_t min);
+void rtc_clear_alarm();
+bool rtc_alarm_enabled(uint8_t *hour, uint8_t *min);
+bool rtc_alarm_pending();
+bool consume_rtc_alarm_event();
+
+void rtc_request_standby();
+bool consume_standby_request();
+
+#endif
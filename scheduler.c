@@ -1,17 +1,127 @@
 
 #include <stdint.h>
 #include "scheduler.h"
+#include "ticker.h"
+#include "timestamp.h"
+#include <msp430.h>
 
+static task_t * const * tasks = 0;
+static uint8_t num_of_tasks = 0;
+static volatile uint16_t pending_tick_ms = 0;   /* 0: no change requested */
+static uint16_t task_mask = 0xFFFF;             /* bit per task index */
 
-void scheduler_run(task_t tasks[],const uint8_t num_of_tasks,uint16_t now) {
+/* Nearest whole number of ticks, at least one */
+static uint16_t ms_to_ticks(uint16_t ms, uint16_t tick_ms) {
+    uint16_t ticks = (uint16_t)((ms + tick_ms / 2) / tick_ms);
+    return ticks ? ticks : 1;
+}
+
+/* Install the task list run by scheduler_run(); periods are in ms */
+void scheduler_init(task_t * const arr[],const uint8_t count) {
+    tasks = arr;
+    num_of_tasks = count;
+    uint16_t tick_ms = ticker_period_ms();
+    for (uint8_t i = 0; i < num_of_tasks; ++i) {
+        tasks[i]->period_ticks = ms_to_ticks(tasks[i]->period_ms, tick_ms);
+    }
+}
+
+void scheduler_run(uint16_t now) {
     for (uint8_t i = 0; i < num_of_tasks; ++i ) {
-        run_task(&tasks[i],now);
+        if (task_mask & (1u << i)) {
+            run_task(tasks[i],now);
+        }
+    }
+}
+
+/* Enable the tasks in mask; re-enabled tasks start from now, no catch-up burst */
+void scheduler_set_task_mask(uint16_t mask, uint16_t now) {
+    uint16_t enabled = mask & ~task_mask;
+    for (uint8_t i = 0; i < num_of_tasks; ++i) {
+        if (enabled & (1u << i)) {
+            tasks[i]->next_run = now;
+        }
+    }
+    task_mask = mask;
+}
+
+uint16_t scheduler_task_mask() {
+    return task_mask;
+}
+
+/* Index of the highest set bit + 1, i.e. 0 for 0, 1 for 1, 2 for 2..3, ... */
+static uint8_t latency_bucket(uint16_t delay) {
+    uint8_t bucket = 0;
+    while (delay) {
+        delay >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+static void record_latency(latency_hist_t * lat, uint16_t delay) {
+    uint8_t bucket = latency_bucket(delay);
+    if (lat->hist[bucket] < UINT16_MAX) {   /* saturate rather than wrap */
+        ++lat->hist[bucket];
+    }
+    if (delay > lat->max) {
+        lat->max = delay;
     }
 }
 
 void run_task(task_t * task, uint16_t now) {
     if ((int16_t)(now - task->next_run) >= 0){ // need to enforce timer period to half of 2^16 due to signed integer conversion here 
+        record_latency(&task->latency, (uint16_t)(timestamp_now() - ticker_last_stamp()));
         task->fn(now);
         task->next_run += task->period_ticks;
     }
 }
+
+uint8_t scheduler_task_count() {
+    return num_of_tasks;
+}
+
+const task_t * scheduler_task(uint8_t i) {
+    return (i < num_of_tasks) ? tasks[i] : 0;
+}
+
+void scheduler_clear_latency() {
+    for (uint8_t i = 0; i < num_of_tasks; ++i) {
+        latency_hist_t * lat = &tasks[i]->latency;
+        lat->max = 0;
+        for (uint8_t b = 0; b < LATENCY_BUCKETS; ++b) {
+            lat->hist[b] = 0;
+        }
+    }
+}
+
+/* TICK <ms>: takes effect at the next tick boundary */
+void scheduler_request_tick_ms(uint16_t ms) {
+    pending_tick_ms = ms;
+}
+
+/*
+ * Called from the main loop between scheduler_run() calls, with now the
+ * next tick number. Reprograms the tick and converts every pending
+ * deadline (ticks left x old ms, rounded up in new ticks) and period in
+ * one critical section, so no task sees a mix of old and new rates.
+ */
+void scheduler_apply_tick_change(uint16_t now) {
+    uint16_t new_ms = pending_tick_ms;
+    if (new_ms == 0) {
+        return;
+    }
+    __disable_interrupt();
+    pending_tick_ms = 0;
+    uint16_t old_ms = ticker_period_ms();
+    if (ticker_set_period_ms(new_ms)) {
+        for (uint8_t i = 0; i < num_of_tasks; ++i) {
+            task_t * task = tasks[i];
+            int16_t left = (int16_t)(task->next_run - now);
+            uint32_t left_ms = (left > 0) ? (uint32_t)left * old_ms : 0;
+            task->next_run = now + (uint16_t)((left_ms + new_ms - 1) / new_ms);
+            task->period_ticks = ms_to_ticks(task->period_ms, new_ms);
+        }
+    }
+    __enable_interrupt();
+}
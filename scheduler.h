@@ -2,17 +2,49 @@
 #define SCHEDULER_H
 
 #include <stdint.h>
+#include "registry.h"
 typedef void (*task_fn_t)(uint16_t); // task function type 
 
+/* Log2 buckets of tick-ISR -> task start delay (timestamp counts, ~1 us):
+ * bucket 0 holds 0, bucket k holds [2^(k-1), 2^k). */
+#define LATENCY_BUCKETS 17
+
+typedef struct {
+    uint16_t max;
+    uint16_t hist[LATENCY_BUCKETS];
+} latency_hist_t;
+
 typedef struct {
+    const char *name;
     task_fn_t fn; 
-    uint16_t period_ticks;
+    uint16_t period_ms;
+    uint16_t period_ticks;      /* derived from period_ms and the tick */
     uint16_t next_run;
+    latency_hist_t latency;
 } task_t;
 
-void scheduler_run(task_t arr[],const uint8_t,uint16_t);
+/*
+ * Register a task_t for the main scheduler. Tasks run in key order within
+ * a tick, and a task's position is its bit in the task mask (tasks.h).
+ * Keys compare as strings: give them a two-digit prefix ("07_SERVO").
+ */
+#define REGISTER_TASK(key, task) \
+    static task_t * const REGISTRY_CAT(task_reg_, task) REGISTRY_ENTRY(task_t *, tasks, key) = &task
+
+REGISTRY_TABLE(task_t *, tasks);
+
+void scheduler_init(task_t * const arr[],const uint8_t);
+void scheduler_run(uint16_t);
 
 void run_task(task_t * task, uint16_t );
 
+uint8_t scheduler_task_count();
+const task_t * scheduler_task(uint8_t);
+void scheduler_clear_latency();
+void scheduler_set_task_mask(uint16_t mask, uint16_t now);
+uint16_t scheduler_task_mask();
+void scheduler_request_tick_ms(uint16_t ms);
+void scheduler_apply_tick_change(uint16_t now);
+
 
 #endif 
@@ -0,0 +1,255 @@
+/**
+ * @file servo.c
+ * @brief Up to 8 RC servos on P3.0..P3.7 from one Timer_B0 compare (CCR2).
+ *
+ * Each 20 ms frame is a plan: one rising edge for every active servo at
+ * the frame start, then the falling edges sorted by pulse width, with
+ * servos of equal width merged into one edge. The compare interrupt
+ * walks the plan; after the last falling edge it schedules the next
+ * frame start. Plans are built by a scheduler task (once per frame, in
+ * main context) into the idle half of a double buffer and swapped in by
+ * the ISR at a frame boundary, so the ISR never sorts or divides.
+ *
+ * Jitter (target: under 1 us): every compare is armed SERVO_GUARD counts
+ * (~10 us) early and the ISR spins on TB0R for the rest, so entry latency
+ * up to the guard (stepper_compare on the same vector, which TB0IV serves
+ * first, UART/tick prologues, short GIE-off sections) is absorbed and the
+ * edge lands on its count. The spin is bounded by the guard: only edges
+ * closer than SERVO_GUARD + SERVO_LEAD counts are chained into the same
+ * run, anything further is re-armed. SERVO reports the worst lateness and
+ * how many edges missed the 1 us target (entry later than the guard).
+ * Servos hold a clock boost while any is on to keep the spin exit and the
+ * entry latency short.
+ *
+ * Motion: a new target is approached at SERVO_SLW us per 20 ms frame
+ * (default 20: 1000 us of travel in 1 s), so console moves are smooth
+ * ramps rather than jumps.
+ */
+
+#include "servo.h"
+#include <msp430.h>
+#include "clock.h"
+#include "param.h"
+#include "scheduler.h"
+#include "timestamp.h"
+#include "uart.h"
+
+#define SERVO_FRAME_US  20000
+#define SERVO_GUARD     10          /* counts each compare is armed early */
+#define SERVO_LEAD      3           /* counts: a nearer compare may be missed */
+
+typedef struct {
+    uint16_t at;                    /* counts after the frame start */
+    uint8_t pins;                   /* P3 bits switched at this edge */
+} servo_edge_t;
+
+/* edge[0] is the frame start (all active pins high), then sorted falling edges */
+typedef struct {
+    servo_edge_t edge[SERVO_COUNT + 1];
+    uint8_t count;
+    uint16_t frame;                 /* frame length in counts */
+} servo_plan_t;
+
+static volatile uint16_t slew = 20;             /* us per 20 ms frame */
+
+REGISTER_PARAM("SERVO_SLW", PARAM_U16, 1, 2000, slew, 0);
+
+static uint16_t target_us[SERVO_COUNT];
+static uint16_t current_us[SERVO_COUNT];
+static uint8_t active = 0;                      /* P3 bit per servo on */
+static bool running = false;
+
+static servo_plan_t plans[2];
+static volatile uint8_t plan_index = 0;         /* plan the ISR is walking */
+static volatile bool plan_ready = false;        /* other plan built, swap at next frame */
+static uint8_t edge_index = 0;
+static uint16_t frame_start = 0;
+static volatile uint16_t frames = 0;
+static uint16_t frames_seen = 0;
+static volatile int16_t late_max = 0;           /* counts past the target edge */
+static volatile uint16_t late_edges = 0;        /* edges past the 1 us target */
+
+/* Step every servo toward its target and build the next frame's plan */
+static void build_plan(uint16_t elapsed) {
+    servo_plan_t *p = &plans[plan_index ^ 1];
+    uint32_t step = (uint32_t)slew * elapsed;
+    uint8_t n = 1;
+    for (uint8_t i = 0; i < SERVO_COUNT; ++i) {
+        if (!(active & (1u << i))) {
+            continue;
+        }
+        uint16_t cur = current_us[i];
+        uint16_t tgt = target_us[i];
+        if (cur < tgt) {
+            cur = ((uint32_t)(tgt - cur) > step) ? (uint16_t)(cur + step) : tgt;
+        } else if (cur > tgt) {
+            cur = ((uint32_t)(cur - tgt) > step) ? (uint16_t)(cur - step) : tgt;
+        }
+        current_us[i] = cur;
+
+        /* insertion into the sorted falling edges, merging equal times */
+        uint16_t at = timestamp_us_to_counts(cur);
+        uint8_t j = n;
+        while (j > 1 && p->edge[j - 1].at > at) {
+            --j;
+        }
+        if (j > 1 && p->edge[j - 1].at == at) {
+            p->edge[j - 1].pins |= (uint8_t)(1u << i);
+            continue;
+        }
+        for (uint8_t k = n; k > j; --k) {
+            p->edge[k] = p->edge[k - 1];
+        }
+        p->edge[j].at = at;
+        p->edge[j].pins = (uint8_t)(1u << i);
+        ++n;
+    }
+    p->edge[0].at = 0;
+    p->edge[0].pins = active;
+    p->count = n;
+    p->frame = timestamp_us_to_counts(SERVO_FRAME_US);
+    plan_ready = true;
+}
+
+static void start() {
+    clock_boost_acquire();
+    frames_seen = frames;
+    build_plan(0);
+    plan_index ^= 1;
+    plan_ready = false;
+    edge_index = 0;
+    frame_start = TB0R + 100;
+    TB0CCR2 = frame_start - SERVO_GUARD;
+    TB0CCTL2 = CCIE;
+    running = true;
+}
+
+static void stop() {
+    TB0CCTL2 = 0;
+    P3OUT &= ~plans[plan_index].edge[0].pins;
+    running = false;
+    plan_ready = false;
+    clock_boost_release();
+}
+
+/* Move servo (0..7) to us; the first position of a servo is taken at once */
+bool servo_set(uint8_t servo, uint16_t us) {
+    if (servo >= SERVO_COUNT || us < SERVO_MIN_US || us > SERVO_MAX_US) {
+        return false;
+    }
+    uint8_t bit = (uint8_t)(1u << servo);
+    target_us[servo] = us;
+    if (!(active & bit)) {
+        current_us[servo] = us;
+        P3OUT &= ~bit;
+        P3DIR |= bit;
+        active |= bit;
+    }
+    if (!running) {
+        start();
+    }
+    return true;
+}
+
+/* Stop pulses on servo (0..7); the last one off stops the timer and the boost */
+void servo_off(uint8_t servo) {
+    if (servo >= SERVO_COUNT) {
+        return;
+    }
+    active &= (uint8_t)~(1u << servo);
+    if (running && active == 0) {
+        stop();
+    }
+    /* a running servo drops out of the next plan; its pin ends low */
+}
+
+/* Task: one plan per frame, after the ISR has taken the previous one */
+void poll_servo(uint16_t g_ticks) {
+    if (!running || plan_ready) {
+        return;
+    }
+    uint16_t now = frames;
+    if (now == frames_seen) {
+        return;
+    }
+    build_plan((uint16_t)(now - frames_seen));
+    frames_seen = now;
+}
+
+static task_t task_servo = {
+    .name = "servo",
+    .fn = poll_servo,
+    .period_ms = 5,
+    .next_run = 0
+};
+REGISTER_TASK("07_SERVO", task_servo);
+
+void servo_report() {
+    uart_puts("\nSERVO SLEW ");
+    uart_put_uint16(slew);
+    uart_puts(" FRAMES ");
+    uart_put_uint16(frames);
+    uart_puts(" LATE ");
+    uart_put_uint16((uint16_t)late_max);
+    uart_puts(" OVER_1US ");
+    uart_put_uint16(late_edges);
+    uart_putc('\n');
+    for (uint8_t i = 0; i < SERVO_COUNT; ++i) {
+        if (!(active & (1u << i))) {
+            continue;
+        }
+        uart_put_uint16(i);
+        uart_putc(' ');
+        uart_put_uint16(current_us[i]);
+        uart_puts(" -> ");
+        uart_put_uint16(target_us[i]);
+        uart_putc('\n');
+    }
+}
+
+/* Spin out the guard; kept out of line so tools/wcet.py can bound it */
+__attribute__((noinline)) static void wait_edge(uint16_t at) {
+    while ((int16_t)(TB0R - at) < 0) {
+    }
+}
+
+/*
+ * Timer_B0 CCR2 (from the shared vector in timestamp.c): spin out the
+ * guard to the due edge, switch its pins, and arm the compare a guard
+ * ahead of the next edge. Edges too close to re-arm are chained, so each
+ * spin is at most SERVO_GUARD + SERVO_LEAD counts.
+ */
+void servo_compare() {
+    const servo_plan_t *p = &plans[plan_index];
+    for (;;) {
+        uint16_t at = frame_start + p->edge[edge_index].at;
+        wait_edge(at);
+        if (edge_index == 0) {
+            P3OUT |= p->edge[0].pins;
+        } else {
+            P3OUT &= ~p->edge[edge_index].pins;
+        }
+        int16_t late = (int16_t)(TB0R - at);
+        if (late > late_max) {
+            late_max = late;
+        }
+        if (late > 1) {
+            ++late_edges;
+        }
+        if (++edge_index == p->count) {
+            frame_start += p->frame;
+            edge_index = 0;
+            ++frames;
+            if (plan_ready) {
+                plan_index ^= 1;
+                plan_ready = false;
+                p = &plans[plan_index];
+            }
+        }
+        uint16_t next = frame_start + p->edge[edge_index].at;
+        if ((int16_t)(next - TB0R) > SERVO_GUARD + SERVO_LEAD) {
+            TB0CCR2 = next - SERVO_GUARD;
+            return;
+        }
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef SERVO_H
+#define SERVO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SERVO_COUNT 8
+#define SERVO_MIN_US 500
+#define SERVO_MAX_US 2500
+
+bool servo_set(uint8_t servo, uint16_t us);
+void servo_off(uint8_t servo);
+void servo_compare();
+void poll_servo(uint16_t);
+void servo_report();
+
+#endif
@@ -0,0 +1,310 @@
+/**
+ * @file stepper.c
+ * @brief Microstepping bipolar stepper on Timer_A2 PWM + Timer_B0 ramp.
+ *
+ * Two H-bridges in phase/enable mode: TA2.1 (P2.4) and TA2.2 (P2.5) are
+ * the coil A/B enables (PWM magnitude), P2.2 and P2.3 the phase
+ * (current direction). The electrical angle is a uint8_t in 1/64-step
+ * units (256 = 4 full steps = one sine period); coil A follows sin, coil
+ * B cos, read from a flash quarter-wave table scaled to the 256-count
+ * PWM period. 1/16, 1/32 or 1/64 microstepping advances the angle by
+ * 4, 2 or 1 per microstep.
+ *
+ * Step timing: Timer_B0 CCR1 interrupts every STEP_UPDATE_COUNTS (~50 us,
+ * 20 kHz) while moving. Each update does one trapezoid step on a Q24
+ * velocity (microsteps per update): add or subtract the acceleration,
+ * add velocity into a 16-bit phase accumulator, and take a microstep on
+ * carry. That is adds and compares only, with no division or multiply,
+ * so the ISR time is constant, and the rate resolves to 20 kHz / 2^16.
+ * Deceleration starts when the steps left equal the steps spent
+ * accelerating, which also gives triangular profiles for short moves.
+ * Top speed is one microstep per update (20 kHz).
+ *
+ * While energized the driver holds a clock boost (PWM at ~62 kHz from
+ * the 16 MHz SMCLK, short ISR) and a PERIPH_TIMER_A2 client.
+ */
+
+#include "stepper.h"
+#include <msp430.h>
+#include "power.h"
+#include "clock.h"
+#include "fault.h"
+#include "param.h"
+#include "timestamp.h"
+#include "uart.h"
+
+#define STEP_PWM_PERIOD     255             /* TA2CCR0: 256 counts */
+#define STEP_UPDATE_COUNTS  50              /* Timer_B0 counts (~1 us) per update */
+#define STEP_UPDATE_HZ      20000UL
+#define V_ONE               0x01000000UL    /* Q24: one microstep per update */
+#define V_START_RATE        100UL           /* microsteps/s: start and end speed */
+#define PHASE_PINS          (BIT2 | BIT3)   /* P2.2 coil A, P2.3 coil B direction */
+#define PWM_PINS            (BIT4 | BIT5)   /* P2.4 TA2.1, P2.5 TA2.2 */
+
+/* round(255 * sin(pi/2 * i / 64)) */
+static const uint8_t quarter_sine[65] = {
+      0,   6,  13,  19,  25,  31,  37,  44,  50,  56,  62,  68,  74,  80,  86,  92,
+     98, 103, 109, 115, 120, 126, 131, 136, 142, 147, 152, 157, 162, 167, 171, 176,
+    180, 185, 189, 193, 197, 201, 205, 208, 212, 215, 219, 222, 225, 228, 231, 233,
+    236, 238, 240, 242, 244, 246, 247, 249, 250, 251, 252, 253, 254, 254, 255, 255,
+    255
+};
+
+/* Tunables (full steps), used at the start of the next move */
+static volatile uint16_t rate = 200;       /* full steps/s */
+static volatile uint16_t accel = 800;      /* full steps/s^2 */
+static volatile uint16_t microsteps = 16;  /* 16, 32 or 64 */
+
+/*
+ * The ramp takes at most one microstep per update, so the top rate is
+ * STEP_UPDATE_HZ / DIV full steps/s (1250, 625 or 312). A faster STEP_RATE
+ * is lowered to it and the console is told.
+ */
+static void rate_changed() {
+    uint16_t top = (uint16_t)(STEP_UPDATE_HZ / microsteps);
+    if (rate > top) {
+        rate = top;
+        uart_puts("\nSTEP_RATE limited to ");
+        uart_put_uint16(top);
+        uart_puts(" at DIV ");
+        uart_put_uint16(microsteps);
+        uart_putc('\n');
+    }
+}
+
+/* Only 1/16, 1/32 and 1/64 are supported: round down to one of them */
+static void microsteps_changed() {
+    microsteps = (microsteps >= 64) ? 64 : (microsteps >= 32) ? 32 : 16;
+    rate_changed();
+}
+
+REGISTER_PARAM("STEP_ACC", PARAM_U16, 1, 20000, accel, 0);
+REGISTER_PARAM("STEP_DIV", PARAM_U16, 16, 64, microsteps, microsteps_changed);
+REGISTER_PARAM("STEP_RATE", PARAM_U16, 1, 1250, rate, rate_changed);
+
+static bool energized = false;
+static volatile bool moving = false;
+static volatile uint8_t angle = 0;          /* 1/64 steps, wraps every 4 full steps */
+static volatile int32_t position = 0;       /* 1/64 steps */
+static volatile int8_t delta = 0;           /* angle change per microstep */
+static volatile uint32_t remaining = 0;     /* microsteps left in the move */
+static volatile uint32_t ramp_steps = 0;    /* microsteps taken while accelerating */
+static volatile bool decelerating = false;
+static uint32_t v = 0;                      /* Q24 microsteps per update */
+static uint32_t v_max = 0;
+static uint32_t v_min = 0;
+static uint32_t dv = 0;                     /* Q24 per update, per update */
+static uint16_t phase_acc = 0;
+static uint16_t isr_max = 0;                /* timestamp counts */
+static uint16_t missed = 0;                 /* updates lost to late entry, all moves */
+
+/* |sin| for a 1/64-step angle; negative half sets *neg */
+static uint8_t coil_level(uint8_t a, bool *neg) {
+    *neg = (a & 0x80) != 0;
+    uint8_t q = a & 0x7F;
+    return quarter_sine[(q > 64) ? (uint8_t)(128 - q) : q];
+}
+
+static void drive(uint8_t a) {
+    bool neg_a, neg_b;
+    TA2CCR1 = coil_level(a, &neg_a);
+    TA2CCR2 = coil_level((uint8_t)(a + 64), &neg_b);
+    P2OUT = (P2OUT & ~PHASE_PINS) | (neg_a ? BIT2 : 0) | (neg_b ? BIT3 : 0);
+}
+
+/* Timer_A2 up mode on SMCLK, reset/set on CCR1/CCR2; left stopped, pins low */
+void stepper_init() {
+    P2OUT &= ~(PHASE_PINS | PWM_PINS);
+    P2DIR |= PHASE_PINS | PWM_PINS;
+    TA2CTL = TASSEL_2 | MC_0 | TACLR;
+    TA2EX0 = 0;
+    TA2CCR0 = STEP_PWM_PERIOD;
+    TA2CCTL1 = OUTMOD_7;
+    TA2CCTL2 = OUTMOD_7;
+    TA2CCR1 = 0;
+    TA2CCR2 = 0;
+}
+
+/* PERIPH_TIMER_A2 start/stop hooks */
+void stepper_start() {
+    TA2CTL |= TACLR;
+    if (!fault_latched()) {
+        P2SEL |= PWM_PINS;
+    }
+    TA2CTL |= MC__UP;
+}
+
+void stepper_stop() {
+    TA2CTL &= ~MC_3;
+    P2SEL &= ~PWM_PINS;
+    P2OUT &= ~PHASE_PINS;
+}
+
+/* Fault cleared: reconnect the enables if the driver is energized */
+void stepper_fault_release() {
+    if (energized) {
+        P2SEL |= PWM_PINS;
+    }
+}
+
+/* Hold the current position (coils powered) */
+void stepper_enable() {
+    if (energized) {
+        return;
+    }
+    energized = true;
+    clock_boost_acquire();
+    drive(angle);
+    power_acquire(PERIPH_TIMER_A2);
+}
+
+/* Stop immediately and release the coils */
+void stepper_disable() {
+    if (!energized) {
+        return;
+    }
+    TB0CCTL1 = 0;
+    moving = false;
+    power_release(PERIPH_TIMER_A2);
+    clock_boost_release();
+    energized = false;
+}
+
+/* microsteps/s -> Q24 per update: r * 2^24 / 20000 ~= (r * 53687) >> 6 */
+static uint32_t rate_to_v(uint32_t r) {
+    if (r >= STEP_UPDATE_HZ) {
+        return V_ONE - 1;
+    }
+    return (r * 53687UL) >> 6;
+}
+
+/*
+ * Start a move of steps full steps (negative: reverse). Energizes the
+ * coils if needed. False while a move is running, a fault is latched or
+ * |steps| is over STEP_MAX_STEPS (the microstep count and position would
+ * overflow).
+ */
+bool stepper_move(int32_t steps) {
+    if (moving || fault_latched() || steps > STEP_MAX_STEPS || steps < -STEP_MAX_STEPS) {
+        return false;
+    }
+    if (steps == 0) {
+        return true;
+    }
+    stepper_enable();
+
+    uint16_t div = microsteps;
+    uint32_t n = (uint32_t)((steps < 0) ? -steps : steps) * div;
+    /* microsteps/s^2 -> Q24 per update^2: a * 2^24 / 20000^2 ~= (a * 2749) >> 16 */
+    uint32_t a = ((uint32_t)accel * div * 2749UL) >> 16;
+    v_max = rate_to_v((uint32_t)rate * div);
+    v_min = rate_to_v(V_START_RATE);
+    if (v_min > v_max) {
+        v_min = v_max;
+    }
+    dv = a ? a : 1;
+    v = v_min;
+    phase_acc = 0;
+    remaining = n;
+    ramp_steps = 0;
+    decelerating = false;
+    delta = (int8_t)((steps < 0) ? -(int16_t)(64 / div) : (int16_t)(64 / div));
+    moving = true;
+    TB0CCR1 = TB0R + STEP_UPDATE_COUNTS;
+    TB0CCTL1 = CCIE;
+    return true;
+}
+
+/* STEP STOP: decelerate to a stop over the steps it took to speed up */
+void stepper_halt() {
+    __disable_interrupt();
+    if (moving && remaining > ramp_steps + 1) {
+        remaining = ramp_steps + 1;
+        decelerating = true;
+    }
+    __enable_interrupt();
+}
+
+bool stepper_moving() {
+    return moving;
+}
+
+void stepper_report() {
+    uart_puts("\nSTEP ");
+    uart_puts(!energized ? "OFF" : moving ? "MOVING" : "HOLD");
+    uart_puts(" POS ");
+    int32_t pos = position;
+    if (pos < 0) {
+        uart_putc('-');
+        pos = -pos;
+    }
+    uart_put_uint32((uint32_t)pos);
+    uart_puts("/64 DIV ");
+    uart_put_uint16(microsteps);
+    uart_puts(" RATE ");
+    uart_put_uint16(rate);
+    uart_puts(" ACC ");
+    uart_put_uint16(accel);
+    uart_puts(" ISR_US ");
+    uart_put_uint16(isr_max);
+    uart_puts(" MISSED ");
+    uart_put_uint16(missed);
+    uart_putc('\n');
+}
+
+/* One ramp update; returns false when the move is done */
+static bool step_update() {
+    if (decelerating) {
+        v = (v > v_min + dv) ? v - dv : v_min;
+    } else if (v < v_max) {
+        v += dv;
+        if (v > v_max) {
+            v = v_max;
+        }
+    }
+    uint16_t before = phase_acc;
+    phase_acc += (uint16_t)(v >> 8);
+    if (phase_acc >= before) {
+        return true;                        /* no carry: no microstep yet */
+    }
+    angle += (uint8_t)delta;
+    position += delta;
+    drive(angle);
+    if (!decelerating && v < v_max) {
+        ++ramp_steps;
+    }
+    if (--remaining == 0) {
+        return false;
+    }
+    if (!decelerating && remaining <= ramp_steps) {
+        decelerating = true;
+    }
+    return true;
+}
+
+/*
+ * Timer_B0 CCR1 (from the shared vector in timestamp.c). The next compare
+ * is scheduled from the previous one, so ISR latency does not accumulate
+ * into the step timing. If entry was so late that the next compare is
+ * already behind TB0R (servo spin on the same vector, GIE-off sections),
+ * it would only match after the counter wraps (~65 ms, coils stalled
+ * mid-step): re-arm from now instead and count the updates skipped.
+ * A latched fault ends the move.
+ */
+void stepper_compare() {
+    uint16_t t0 = TB0R;
+    TB0CCR1 += STEP_UPDATE_COUNTS;
+    int16_t ahead = (int16_t)(TB0CCR1 - TB0R);
+    if (ahead <= 0) {
+        missed += (uint16_t)(-ahead) / STEP_UPDATE_COUNTS + 1;
+        TB0CCR1 = TB0R + STEP_UPDATE_COUNTS;
+    }
+    if (fault_latched() || !step_update()) {
+        TB0CCTL1 = 0;
+        moving = false;
+    }
+    uint16_t dt = (uint16_t)(TB0R - t0);
+    if (dt > isr_max) {
+        isr_max = dt;
+    }
+}
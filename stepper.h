@@ -0,0 +1,21 @@
+#ifndef STEPPER_H
+#define STEPPER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define STEP_MAX_STEPS 1000000L      /* full steps per move, either way */
+
+void stepper_init();
+void stepper_start();
+void stepper_stop();
+void stepper_fault_release();
+void stepper_enable();
+void stepper_disable();
+bool stepper_move(int32_t steps);
+void stepper_halt();
+bool stepper_moving();
+void stepper_report();
+void stepper_compare();
+
+#endif
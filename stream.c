@@ -0,0 +1,48 @@
+/**
+ * @file stream.c
+ * @brief Binary sample and telemetry frames on the console UART (see stream.h).
+ */
+
+#include "stream.h"
+#include "uart.h"
+
+void stream_put_sample(uint8_t ch, uint16_t stamp, uint16_t value) {
+    uint8_t frame[STREAM_FRAME_LEN] = {
+        STREAM_SYNC,
+        ch,
+        (uint8_t)stamp, (uint8_t)(stamp >> 8),
+        (uint8_t)value, (uint8_t)(value >> 8),
+        0
+    };
+    for (uint8_t i = 0; i < STREAM_FRAME_LEN - 1; ++i) {
+        frame[STREAM_FRAME_LEN - 1] ^= frame[i];
+    }
+    for (uint8_t i = 0; i < STREAM_FRAME_LEN; ++i) {
+        uart_putc((char)frame[i]);
+    }
+}
+
+/* XOR is accumulated while sending, so the frame is never buffered */
+void stream_put_telemetry(uint16_t stamp, const uint8_t *topics, const uint16_t *values, uint8_t n) {
+    uint8_t header[TELEM_HEADER_LEN] = {
+        TELEM_SYNC,
+        n,
+        (uint8_t)stamp, (uint8_t)(stamp >> 8)
+    };
+    uint8_t x = 0;
+    for (uint8_t i = 0; i < TELEM_HEADER_LEN; ++i) {
+        x ^= header[i];
+        uart_putc((char)header[i]);
+    }
+    for (uint8_t r = 0; r < n; ++r) {
+        uint8_t rec[TELEM_RECORD_LEN] = {
+            topics[r],
+            (uint8_t)values[r], (uint8_t)(values[r] >> 8)
+        };
+        for (uint8_t i = 0; i < TELEM_RECORD_LEN; ++i) {
+            x ^= rec[i];
+            uart_putc((char)rec[i]);
+        }
+    }
+    uart_putc((char)x);
+}
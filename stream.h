@@ -0,0 +1,43 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdint.h>
+
+/*
+ * Binary sample frame, interleaved with console text on USCI_A1:
+ *   [0] STREAM_SYNC
+ *   [1] channel
+ *   [2..3] timestamp counts (~1 us, wraps), little-endian
+ *   [4..5] value, little-endian
+ *   [6] XOR of bytes 0..5
+ * Also included by the host capture tool (tools/capture).
+ */
+#define STREAM_SYNC 0xA5
+#define STREAM_FRAME_LEN 7
+
+#define STREAM_CH_A0 0
+
+/*
+ * Telemetry frame (SUB, telemetry.c), all records due in one tick:
+ *   [0] TELEM_SYNC
+ *   [1] record count n, 1..TELEM_MAX_RECORDS
+ *   [2..3] timestamp counts, little-endian
+ *   n x { topic, value little-endian }
+ *   [last] XOR of all previous bytes
+ */
+#define TELEM_SYNC 0xA6
+#define TELEM_HEADER_LEN 4
+#define TELEM_RECORD_LEN 3
+#define TELEM_MAX_RECORDS 19       /* 3 single topics + 16 tasks */
+#define TELEM_FRAME_LEN(n) (TELEM_HEADER_LEN + TELEM_RECORD_LEN * (n) + 1)
+
+/* Record topics; the capture tool stores them as channels (A0 is 0) */
+#define TELEM_TOPIC_ADC 1           /* published ADC value */
+#define TELEM_TOPIC_DUTY 2          /* PWM duty, 0.1% */
+#define TELEM_TOPIC_BTN 3           /* long presses << 8 | short presses */
+#define TELEM_TOPIC_TASK 16         /* + task index: worst start latency */
+
+void stream_put_sample(uint8_t ch, uint16_t stamp, uint16_t value);
+void stream_put_telemetry(uint16_t stamp, const uint8_t *topics, const uint16_t *values, uint8_t n);
+
+#endif
@@ -5,20 +5,109 @@
 #include "button.h"
 #include "led.h"
 #include "command.h"
+#include "init.h"
+#include "flash_crc.h"
+#include "power.h"
+#include "rtc.h"
+#include "clock.h"
+#include "cmd_rtc.h"
+#include "tasks.h"
+#include "stream.h"
+#include "mode.h"
+#include "pipeline.h"
 
 
-void poll_adc(uint16_t g_ticks) {
-    uint16_t adc_value; 
-    /* Check if ADC module has published a new value */
-    if(poll_adc_value(&adc_value)){
-        /* Map 12‑bit value (0..4095) to duty cycle fraction (0.0..1.0) */
-        float duty_cycle = (float) adc_value / 4095.0f ; 
-        set_pwm_duty_cycle(duty_cycle);
-        //uart_put_uint16(adc_value);
-        //uart_puts("\n");
-        }
+/* Run deferred driver init one stage per tick until boot completes */
+void poll_init(uint16_t g_ticks) {
+    init_step();
+}
+
+static bool duty_from_adc = false;
+
+/* Auto duty holds an ADC12 client; manual duty (SET DUTY x) releases it */
+void set_duty_from_adc(bool on) {
+    if (on == duty_from_adc) {
+        return;
+    }
+    duty_from_adc = on;
+    if (on) {
+        power_acquire(PERIPH_ADC12);
+    } else {
+        power_release(PERIPH_ADC12);
+    }
+}
+
+/*
+ * ADC -> PWM, the first pipeline (pipeline.c):
+ *
+ *   shift --> log          CUSUM shift events, reported with the time
+ *   adc --> duty --> pwm   published value -> fraction -> PWM duty
+ *
+ * Stage order puts the CUSUM report before the new level is applied.
+ */
+enum { ADC_SHIFT, ADC_SHIFT_LOG, ADC_VALUE, ADC_DUTY, ADC_PWM, ADC_NUM_STAGES };
+
+/* Published ADC values since the last run, oldest first, up to a batch */
+static void adc_value_source(const pipe_batch_t *in, pipe_batch_t *out) {
+    uint16_t value;
+    while (out->n < PIPE_BATCH && poll_adc_value(&value)) {
+        out->v[out->n++] = value;
+    }
+}
+
+/* CUSUM mode: +1 / -1 per detected mean shift */
+static void adc_shift_source(const pipe_batch_t *in, pipe_batch_t *out) {
+    int8_t dir;
+    if (consume_adc_change_event(&dir)) {
+        out->v[out->n++] = (uint16_t)(int16_t)dir;
+    }
+}
+
+static void shift_log_sink(const pipe_batch_t *in, pipe_batch_t *out) {
+    for (uint8_t i = 0; i < in->n; ++i) {
+        uart_puts((int16_t)in->v[i] > 0 ? "\nCHG + " : "\nCHG - ");
+        rtc_put_time();
+    }
+}
+
+/* Map 12-bit value (0..4095) to a duty fraction (0..0x8000) */
+static void adc_to_duty(const pipe_batch_t *in, pipe_batch_t *out) {
+    for (uint8_t i = 0; i < in->n; ++i) {
+        out->v[i] = (uint16_t)(((uint32_t)in->v[i] * 0x8000UL + 2047) / 4095);
+    }
+    out->n = in->n;
+}
+
+/* Only the newest duty of a batch reaches the timer */
+static void pwm_duty_sink(const pipe_batch_t *in, pipe_batch_t *out) {
+    set_pwm_duty_frac(in->v[in->n - 1]);
 }
 
+static const pipe_stage_t adc_stages[ADC_NUM_STAGES] = {
+    [ADC_SHIFT]     = { "shift", PIPE_NONE,  PIPE_EVENT, adc_shift_source },
+    [ADC_SHIFT_LOG] = { "log",   PIPE_EVENT, PIPE_NONE,  shift_log_sink },
+    [ADC_VALUE]     = { "adc",   PIPE_NONE,  PIPE_ADC12, adc_value_source },
+    [ADC_DUTY]      = { "duty",  PIPE_ADC12, PIPE_FRAC,  adc_to_duty },
+    [ADC_PWM]       = { "pwm",   PIPE_FRAC,  PIPE_NONE,  pwm_duty_sink },
+};
+
+static const pipe_edge_t adc_edges[] = {
+    { ADC_SHIFT, ADC_SHIFT_LOG },
+    { ADC_VALUE, ADC_DUTY },
+    { ADC_DUTY,  ADC_PWM },
+};
+
+static pipe_state_t adc_pipe_state;
+
+static const pipeline_t adc_pipe = {
+    .name = "ADC",
+    .stages = adc_stages,
+    .num_stages = ADC_NUM_STAGES,
+    .edges = adc_edges,
+    .num_edges = sizeof(adc_edges) / sizeof(adc_edges[0]),
+    .state = &adc_pipe_state,
+};
+
 void poll_button(uint16_t g_ticks) {
     button_debounce();
     update_button_state(g_ticks);
@@ -27,6 +116,7 @@ void poll_button(uint16_t g_ticks) {
     }
     if(consume_long_press_event()) {
         led_p4_toggle();
+        mode_gesture();     /* leaves ECO */
     }
 }
 
@@ -41,3 +131,80 @@ void poll_uart_rx(uint16_t g_ticks) {
     }
 }
 
+
+void poll_flash_crc(uint16_t g_ticks) {
+    if(consume_crc_alarm_event()) {
+        uart_puts("\nALARM CRC ");
+        rtc_put_time();
+        flash_crc_report();
+    }
+}
+
+void poll_rtc(uint16_t g_ticks) {
+    clock_xt1_poll();
+    if(consume_rtc_alarm_event()) {
+        rtc_run_alarm_job();
+    }
+}
+
+/* Send queued ADC samples as binary frames (LOG ADC ON) */
+void poll_adc_stream(uint16_t g_ticks) {
+    uint16_t stamp, value;
+    while (adc_stream_pop(&stamp, &value)) {
+        stream_put_sample(STREAM_CH_A0, stamp, value);
+    }
+}
+
+/*
+ * Application tasks (also run by the host replay build); periods in ms.
+ * Keys sort into the TASK_x order of tasks.h.
+ */
+static task_t task_init = {
+    .name = "init",
+    .fn = poll_init,
+    .period_ms = 5,
+    .next_run = 0
+};
+REGISTER_TASK("00_INIT", task_init);
+
+static task_t task_button = {
+    .name = "button",
+    .fn = poll_button,
+    .period_ms = 5,
+    .next_run = 0
+};
+REGISTER_TASK("01_BUTTON", task_button);
+
+static task_t task_stream = {
+    .name = "stream",
+    .fn = poll_adc_stream,
+    .period_ms = 5,
+    .next_run = 0
+};
+REGISTER_TASK("02_STREAM", task_stream);
+
+REGISTER_PIPELINE("03_ADC", "adc", adc_pipe, 25);
+
+static task_t task_uart_rx = {
+    .name = "uart_rx",
+    .fn = poll_uart_rx,
+    .period_ms = 25,
+    .next_run = 0
+};
+REGISTER_TASK("04_UART_RX", task_uart_rx);
+
+static task_t task_crc = {
+    .name = "crc",
+    .fn = poll_flash_crc,
+    .period_ms = 100,
+    .next_run = 0
+};
+REGISTER_TASK("05_CRC", task_crc);
+
+static task_t task_rtc = {
+    .name = "rtc",
+    .fn = poll_rtc,
+    .period_ms = 100,
+    .next_run = 0
+};
+REGISTER_TASK("06_RTC", task_rtc);
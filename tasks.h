@@ -1,8 +1,37 @@
 #ifndef TASKS_H
 #define TASKS_H
 
-void poll_adc(uint16_t);
+#include <stdint.h>
+#include <stdbool.h>
+#include "scheduler.h"
+
+/*
+ * Position of each registered task, i.e. its bit in scheduler task masks.
+ * The REGISTER_TASK keys in tasks.c ("00_INIT", ...) sort into this order;
+ * tasks registered elsewhere sort after them and are in TASK_ALL. Keys are
+ * sorted as strings (SORT_BY_NAME), so the number is always two digits:
+ * "10_X" after "09_TELEM", where a "10_X" would land before "1_BUTTON".
+ */
+enum {
+    TASK_INIT,
+    TASK_BUTTON,
+    TASK_STREAM,
+    TASK_ADC,
+    TASK_UART_RX,
+    TASK_CRC,
+    TASK_RTC
+};
+
+#define TASK_BIT(t) (1u << (t))
+#define TASK_ALL 0xFFFFu
+
+void set_duty_from_adc(bool);
+
+void poll_init(uint16_t);
 void poll_button(uint16_t);
 void poll_uart_rx(uint16_t);
+void poll_flash_crc(uint16_t);
+void poll_rtc(uint16_t);
+void poll_adc_stream(uint16_t);
 
 #endif
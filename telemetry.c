@@ -0,0 +1,200 @@
+/**
+ * @file telemetry.c
+ * @brief Subscription telemetry: topics pushed at a rate or on change.
+ *
+ * The host subscribes once (SUB <topic> <ms|CHG>) and the device pushes
+ * from then on without further requests. Every tick the telemetry task
+ * gathers all records that are due into one TELEM_SYNC frame (stream.h),
+ * so the 5 bytes of frame overhead are paid once per tick, not per value,
+ * and topics nobody subscribed to are never read or sent.
+ *
+ *   ADC    published ADC value (the one that drives the duty)
+ *   DUTY   PWM duty in 0.1% steps
+ *   BTN    press counts, long << 8 | short
+ *   TASKS  worst tick -> start latency of each task, one record per task
+ *
+ * A rate subscription sends all of the topic's records every <ms>,
+ * rounded to ticks. An on-change subscription is checked every tick and
+ * sends only the records that differ from the last value sent (all of
+ * them right after SUB).
+ */
+
+#include "telemetry.h"
+#include <string.h>
+#include "adc.h"
+#include "button.h"
+#include "pwm.h"
+#include "scheduler.h"
+#include "stream.h"
+#include "ticker.h"
+#include "timestamp.h"
+#include "uart.h"
+
+#define TELEM_TOPIC_IDS 32          /* record topic ids 0..31 */
+
+typedef uint8_t (*telem_read_t)(uint16_t *values, uint8_t max);
+
+typedef struct {
+    const char *name;
+    uint8_t topic;                  /* id of the first record */
+    telem_read_t read;              /* fills values, returns the count */
+} telem_topic_t;
+
+static uint8_t read_adc(uint16_t *values, uint8_t max) {
+    values[0] = adc_last_value();
+    return 1;
+}
+
+static uint8_t read_duty(uint16_t *values, uint8_t max) {
+    values[0] = pwm_duty_permille();
+    return 1;
+}
+
+static uint8_t read_button(uint16_t *values, uint8_t max) {
+    values[0] = button_press_counts();
+    return 1;
+}
+
+static uint8_t read_tasks(uint16_t *values, uint8_t max) {
+    uint8_t n = scheduler_task_count();
+    if (n > max) {
+        n = max;
+    }
+    for (uint8_t i = 0; i < n; ++i) {
+        values[i] = scheduler_task(i)->latency.max;
+    }
+    return n;
+}
+
+static const telem_topic_t topics[] = {
+    { "ADC",   TELEM_TOPIC_ADC,  read_adc },
+    { "DUTY",  TELEM_TOPIC_DUTY, read_duty },
+    { "BTN",   TELEM_TOPIC_BTN,  read_button },
+    { "TASKS", TELEM_TOPIC_TASK, read_tasks },
+};
+
+#define NUM_TOPICS (sizeof(topics) / sizeof(topics[0]))
+
+static uint16_t period_ms[NUM_TOPICS];      /* 0 = not subscribed */
+static uint16_t left_ms[NUM_TOPICS];
+static uint8_t fresh = 0;                   /* bit per topic: send all next tick */
+static uint16_t last_sent[TELEM_TOPIC_IDS];
+static uint16_t last_ticks = 0;
+static uint16_t frames = 0;
+
+static int8_t find_topic(const char *name) {
+    for (uint8_t t = 0; t < NUM_TOPICS; ++t) {
+        if (strcmp(name, topics[t].name) == 0) {
+            return (int8_t)t;
+        }
+    }
+    return -1;
+}
+
+/* ms: 1..TELEM_MAX_MS or TELEM_ON_CHANGE; replaces an earlier subscription */
+bool telemetry_subscribe(const char *topic, uint16_t ms) {
+    int8_t t = find_topic(topic);
+    if (t < 0 || ms == 0 || (ms > TELEM_MAX_MS && ms != TELEM_ON_CHANGE)) {
+        return false;
+    }
+    period_ms[t] = ms;
+    fresh |= (uint8_t)(1u << t);            /* first frame on the next tick */
+    return true;
+}
+
+/* Topic name or ALL */
+bool telemetry_unsubscribe(const char *topic) {
+    if (strcmp(topic, "ALL") == 0) {
+        memset(period_ms, 0, sizeof period_ms);
+        return true;
+    }
+    int8_t t = find_topic(topic);
+    if (t < 0) {
+        return false;
+    }
+    period_ms[t] = 0;
+    return true;
+}
+
+/* Rate topics: count down by the elapsed ms, keeping the phase */
+static bool rate_due(uint8_t t, uint16_t elapsed) {
+    if (elapsed < left_ms[t]) {
+        left_ms[t] -= elapsed;
+        return false;
+    }
+    uint16_t over = elapsed - left_ms[t];
+    left_ms[t] = (over < period_ms[t]) ? (uint16_t)(period_ms[t] - over) : period_ms[t];
+    return true;
+}
+
+/* Every tick: one frame with every due record, nothing if none */
+void poll_telemetry(uint16_t g_ticks) {
+    uint32_t ms = (uint32_t)(uint16_t)(g_ticks - last_ticks) * ticker_period_ms();
+    uint16_t elapsed = (ms > 0xFFFFu) ? 0xFFFFu : (uint16_t)ms;
+    last_ticks = g_ticks;
+
+    uint8_t rec_topic[TELEM_MAX_RECORDS];
+    uint16_t rec_value[TELEM_MAX_RECORDS];
+    uint8_t n = 0;
+    for (uint8_t t = 0; t < NUM_TOPICS; ++t) {
+        if (period_ms[t] == 0) {
+            continue;
+        }
+        bool on_change = period_ms[t] == TELEM_ON_CHANGE;
+        bool first = (fresh & (1u << t)) != 0;
+        if (first) {
+            left_ms[t] = period_ms[t];
+        } else if (!on_change && !rate_due(t, elapsed)) {
+            continue;
+        }
+        bool all = !on_change || first;
+        uint16_t values[TELEM_MAX_RECORDS];
+        uint8_t count = topics[t].read(values, (uint8_t)(TELEM_MAX_RECORDS - n));
+        for (uint8_t i = 0; i < count; ++i) {
+            uint8_t id = (uint8_t)((topics[t].topic + i) & (TELEM_TOPIC_IDS - 1));
+            if (!all && values[i] == last_sent[id]) {
+                continue;
+            }
+            last_sent[id] = values[i];
+            rec_topic[n] = id;
+            rec_value[n] = values[i];
+            ++n;
+        }
+        fresh &= (uint8_t)~(1u << t);
+    }
+    if (n == 0) {
+        return;
+    }
+    stream_put_telemetry(timestamp_now(), rec_topic, rec_value, n);
+    ++frames;
+}
+
+static task_t task_telemetry = {
+    .name = "telem",
+    .fn = poll_telemetry,
+    .period_ms = 1,             /* every tick */
+    .next_run = 0
+};
+REGISTER_TASK("09_TELEM", task_telemetry);
+
+void telemetry_report() {
+    uart_puts("\nTOPIC ID PERIOD\n");
+    for (uint8_t t = 0; t < NUM_TOPICS; ++t) {
+        uart_puts(topics[t].name);
+        uart_putc(' ');
+        uart_put_uint16(topics[t].topic);
+        uart_putc(' ');
+        if (period_ms[t] == 0) {
+            uart_puts("OFF");
+        } else if (period_ms[t] == TELEM_ON_CHANGE) {
+            uart_puts("CHG");
+        } else {
+            uart_put_uint16(period_ms[t]);
+            uart_puts("ms");
+        }
+        uart_putc('\n');
+    }
+    uart_puts("FRAMES ");
+    uart_put_uint16(frames);
+    uart_putc('\n');
+}
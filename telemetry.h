@@ -0,0 +1,15 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TELEM_ON_CHANGE 0xFFFFu     /* subscription period: send on change */
+#define TELEM_MAX_MS 60000u
+
+bool telemetry_subscribe(const char *topic, uint16_t ms);
+bool telemetry_unsubscribe(const char *topic);
+void poll_telemetry(uint16_t);
+void telemetry_report();
+
+#endif
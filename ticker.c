@@ -1,13 +1,16 @@
 
 #include "ticker.h"
 #include <msp430.h>
+#include "timestamp.h"
+#include "record.h"
+#include "nest.h"
 
 /**
  * @file timer.c
  * @brief ACLK-based periodic tick using Timer1_A CCR0.
  *
- * Generates a fixed-period software tick (default: 5 ms) 
- * ACLK using TimerA1 in up mode. The tick is exposed via a simple
+ * Generates a periodic software tick (default: 5 ms, changeable at run
+ * time with ticker_set_period_ms()) from ACLK using TimerA1 in up mode. The tick is exposed via a simple
  * consume_tick() API that returns true once per timer period.
  *
  */
@@ -27,9 +30,12 @@
 
 #define TIMER_PERIOD_MS 5UL /* 5 ms */
 
-#define TIMER_CCR0_VALUE TIMER_CCR0_FROM_MS(TIMER_PERIOD_MS)
+static uint16_t period_ms = TIMER_PERIOD_MS;
 
 static volatile bool tick_flag = false;
+static volatile uint16_t tick_stamp = 0;    /* timestamp_now() at ISR entry */
+static volatile uint16_t tick_count = 0;    /* ISR count, wraps at 65535 */
+static volatile uint16_t tick_lag_max = 0;  /* worst TA1R at ISR entry (ACLK counts) */
 
 /**
  * Configure Timer1_A to generate a periodic interrupt on CCR0.
@@ -42,12 +48,17 @@ void ticker_init() {
     TA1EX0 = 0;                          /* Expansion divider /1 */
     TA1CTL |= TACLR;                     /* Clear timer and divider logic */
     TA1CCTL0 |= CCIE;                    /* Enable CCR0 interrupt */
-    TA1CCR0 = TIMER_CCR0_VALUE;          /* Set CCR0 for desired tick period */
+    TA1CCR0 = TIMER_CCR0_FROM_MS(period_ms); /* Set CCR0 for desired tick period */
 }
 void ticker_on() {
     TA1CTL |= MC__UP;
 }
 
+/* Stop the tick (standby); ticker_on() resumes from the same count */
+void ticker_off() {
+    TA1CTL &= ~MC_3;
+}
+
 bool consume_tick() { 
        // enter_lpm here and wakeup from ticker ISR 
     if(tick_flag) { 
@@ -58,6 +69,51 @@ bool consume_tick() {
 
 }
 
+/* True while a tick has fired but not been consumed yet */
+bool ticker_pending() {
+    return tick_flag;
+}
+
+uint16_t ticker_ticks() {
+    return tick_count;
+}
+
+/*
+ * Worst tick entry lag: in up mode TA1R restarts from 0 when CCIFG is
+ * set, so its value on ISR entry is the time the request waited.
+ */
+uint16_t ticker_max_lag() {
+    return tick_lag_max;
+}
+
+void ticker_clear_lag() {
+    tick_lag_max = 0;
+}
+
+uint16_t ticker_period_ms() {
+    return period_ms;
+}
+
+/*
+ * New period from the next tick on. TACLR restarts the count so a CCR0
+ * below the current TA1R cannot run the timer through a full 16-bit wrap.
+ * Call with interrupts off, right after a tick (scheduler_apply_tick_change).
+ */
+bool ticker_set_period_ms(uint16_t ms) {
+    if (ms < TICK_MS_MIN || ms > TICK_MS_MAX) {
+        return false;
+    }
+    period_ms = ms;
+    TA1CCR0 = TIMER_CCR0_FROM_MS(ms);
+    TA1CTL |= TACLR;
+    return true;
+}
+
+/* Timestamp taken on entry to the most recent tick ISR */
+uint16_t ticker_last_stamp() {
+    return tick_stamp;
+}
+
 /*
  * Timer1_A CCR0 ISR.
  *
@@ -67,9 +123,18 @@ bool consume_tick() {
  */
 #pragma vector=TIMER1_A0_VECTOR
 __interrupt void timerA1Elapsed() {
-    /* Wake main from LPM0 so it can run scheduled tasks */
-     __bic_SR_register_on_exit(LPM0_bits);
+    uint16_t lag = TA1R;
+    tick_stamp = timestamp_now();   /* first: reference point for task start latency */
+    if (lag > tick_lag_max) {
+        tick_lag_max = lag;
+    }
+    nest_note_stack();              /* innermost frame when preempting a nested ISR */
+    RECORD_TICK(tick_stamp);
+    /* Wake main from LPM0/LPM3 so it can run scheduled tasks */
+    nest_wake();
+    __bic_SR_register_on_exit(LPM3_bits);
     tick_flag = true; 
+    ++tick_count;
 }
 
 
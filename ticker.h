@@ -4,9 +4,20 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#define TICK_MS_MIN 1
+#define TICK_MS_MAX 1999        /* CCR0 limit at 32768 Hz */
+
 
 void ticker_on();
+void ticker_off();
 void ticker_init();
 bool consume_tick();
+bool ticker_pending();
+uint16_t ticker_ticks();
+uint16_t ticker_last_stamp();
+uint16_t ticker_period_ms();
+bool ticker_set_period_ms(uint16_t ms);
+uint16_t ticker_max_lag();
+void ticker_clear_lag();
 
 #endif
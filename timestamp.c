@@ -0,0 +1,89 @@
+/**
+ * @file timestamp.c
+ * @brief Free-running Timer_B0 counter used as a fine-grained timestamp.
+ *
+ * Timer_B0 runs in continuous mode from SMCLK (~1 MHz), so one count is
+ * roughly 1 us and the counter wraps every ~65 ms. Differences of two
+ * timestamps are wraparound-safe as long as the interval is shorter
+ * than one wrap, which covers everything measured within a 5 ms tick.
+ * When SMCLK is boosted the input dividers are retuned to keep ~1 MHz.
+ * CCR1/CCR2 compares are lent to the stepper and servo drivers.
+ */
+
+#include <msp430.h>
+#include "timestamp.h"
+#include "clock.h"
+#include "stepper.h"
+#include "servo.h"
+
+#define TIMESTAMP_HZ 1000000UL
+
+static uint32_t count_hz = 0;           /* actual count rate: SMCLK / dividers */
+
+/* Start Timer_B0 free-running on SMCLK /1; no interrupts are used */
+void timestamp_init() {
+    TB0CTL = TBSSEL__SMCLK | MC_0;       /* SMCLK, stop while configuring */
+    TB0CTL = (TB0CTL & ~ID_3) | ID_0;    /* /1 divider */
+    TB0EX0 = 0;                          /* Expansion divider /1 */
+    TB0CTL |= TBCLR;                     /* Clear counter and divider logic */
+    TB0CTL |= MC__CONTINUOUS;            /* count 0..0xFFFF and wrap */
+    count_hz = clock_smclk_hz();
+}
+
+/* Current counter value; subtract two readings as uint16_t for elapsed time */
+uint16_t timestamp_now() {
+    return TB0R;
+}
+
+/*
+ * Pick ID (/1../8) and IDEX (/1../8) so SMCLK / (ID * IDEX) ~= 1 MHz.
+ * TBCLR is deliberately not set: the counter keeps running across the
+ * switch so intervals spanning it stay usable (first divider period is
+ * off by at most one input clock).
+ */
+void timestamp_clock_changed() {
+    uint16_t div = (uint16_t)((clock_smclk_hz() + TIMESTAMP_HZ / 2) / TIMESTAMP_HZ);
+    for (uint8_t id = 3; ; --id) {
+        uint16_t ex = div >> id;
+        if ((div & ((1U << id) - 1)) == 0 && ex >= 1 && ex <= 8) {
+            TB0CTL = (TB0CTL & ~ID_3) | (id << 6);   /* ID field, bits 7..6 */
+            TB0EX0 = ex - 1;
+            count_hz = clock_smclk_hz() / div;
+            return;
+        }
+        if (id == 0) {
+            break;
+        }
+    }
+    TB0CTL = (TB0CTL & ~ID_3) | ID_0;       /* fall back to /1 */
+    TB0EX0 = 0;
+    count_hz = clock_smclk_hz();
+}
+
+/*
+ * Exact conversion for scheduling compares; main context (divides). Both
+ * count rates are multiples of 16 Hz, so scaling by 1/16 keeps
+ * us * rate within 32 bits for any 16-bit us.
+ */
+uint16_t timestamp_us_to_counts(uint16_t us) {
+    return (uint16_t)(((uint32_t)us * (count_hz >> 4) + TIMESTAMP_HZ / 32) / (TIMESTAMP_HZ >> 4));
+}
+
+/*
+ * Timer_B0 CCR1..6 + overflow share one vector. The compare channels are
+ * owned by their users: CCR1 steps the stepper ramp, CCR2 the servo
+ * frame. The timestamp itself takes no interrupts.
+ */
+#pragma vector=TIMER0_B1_VECTOR
+__interrupt void timerB0Compare() {
+    switch (__even_in_range(TB0IV, 14)) {
+    case 2:                                 /* CCR1 */
+        stepper_compare();
+        break;
+    case 4:                                 /* CCR2 */
+        servo_compare();
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,11 @@
+#ifndef TIMESTAMP_H
+#define TIMESTAMP_H
+
+#include <stdint.h>
+
+void timestamp_init();
+uint16_t timestamp_now();
+void timestamp_clock_changed();
+uint16_t timestamp_us_to_counts(uint16_t us);
+
+#endif
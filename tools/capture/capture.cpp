@@ -0,0 +1,412 @@
+// capture: device sample stream -> memory-mapped columnar file.
+//
+//   capture record <tty> <file> [-b baud] [-r rate] [-n frames] [-s seconds]
+//   capture info   <file>
+//   capture read   <file> <row> [count]
+//   capture at     <file> <t>
+//   capture bench  [frames]
+//
+// record reads LOG ADC ON sample frames and SUB telemetry frames (one
+// row per record, channel = topic) from a serial port (or PTY) until
+// Ctrl-C or a limit, committing rows after every read; -r first
+// negotiates the console up from -b to rate (BAUD, baud.c) and records
+// at -b if the device does not verify it. bench runs the
+// same read/parse/append loop against a synthetic PTY producer and
+// reports throughput against the 115200 baud link.
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "baud.h"
+#include "colfile.hpp"
+#include "parser.hpp"
+
+using namespace capture;
+
+namespace {
+
+constexpr size_t kReadBytes = 1 << 16;
+constexpr double kLinkBytesPerSec = 115200.0 / 10.0;   // 8N1
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void on_sigint(int) { g_stop = 1; }
+
+speed_t baud_constant(long baud) {
+    switch (baud) {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    default: return 0;
+    }
+}
+
+bool make_raw(int fd, long baud) {
+    termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        return false;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    if (baud) {
+        speed_t s = baud_constant(baud);
+        if (!s) {
+            std::fprintf(stderr, "unsupported baud %ld\n", baud);
+            return false;
+        }
+        cfsetispeed(&tio, s);
+        cfsetospeed(&tio, s);
+    }
+    return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+// One console line without the terminator; false on timeout or error.
+// Binary frames in between just make lines that match nothing.
+bool read_line(int fd, std::string &line, int timeout_ms) {
+    line.clear();
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(end - std::chrono::steady_clock::now());
+        pollfd p = {fd, POLLIN, 0};
+        if (left.count() <= 0 || ::poll(&p, 1, int(left.count())) <= 0) {
+            return false;
+        }
+        char c;
+        if (::read(fd, &c, 1) != 1) {
+            return false;
+        }
+        if (c == '\n') {
+            return true;
+        }
+        if (c != '\r' && line.size() < 256) {
+            line += c;
+        }
+    }
+}
+
+// Read lines until one equals want; false on timeout
+bool expect_line(int fd, const std::string &want, int timeout_ms) {
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    std::string line;
+    while (std::chrono::steady_clock::now() < end) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(end - std::chrono::steady_clock::now());
+        if (read_line(fd, line, int(left.count())) && line == want) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool send_line(int fd, const std::string &s) {
+    std::string l = s + "\n";
+    return ::write(fd, l.data(), l.size()) == ssize_t(l.size()) && tcdrain(fd) == 0;
+}
+
+// Host side of BAUD: propose, switch on the ACK, echo the test line and
+// wait for OK. On any failure the port goes back to baud, where the
+// device also ends up after its 1 s trial.
+bool negotiate(int fd, long baud, long rate) {
+    std::string r = std::to_string(rate);
+    if (!send_line(fd, "BAUD " + r) || !expect_line(fd, "ACK " + r, 1000)) {
+        std::fprintf(stderr, "BAUD %ld not acknowledged\n", rate);
+        return false;
+    }
+    bool ok = make_raw(fd, rate) && tcflush(fd, TCIFLUSH) == 0 &&
+              expect_line(fd, "BAUD TEST " BAUD_PATTERN, 500) &&
+              send_line(fd, "BAUD CHECK " BAUD_PATTERN) &&
+              expect_line(fd, "BAUD " + r + " OK", 500);
+    if (!ok) {
+        std::fprintf(stderr, "BAUD %ld not verified, staying at %ld\n", rate, baud);
+        make_raw(fd, baud);
+    }
+    return ok;
+}
+
+struct RecordResult {
+    ParseStats stats;
+    double seconds = 0;
+    bool ok = true;
+};
+
+// Read fd until EOF, g_stop or a limit; one commit per read.
+RecordResult record_fd(int fd, ColumnFile &out, uint64_t max_frames, double max_seconds) {
+    RecordResult res;
+    FrameParser parser;
+    std::vector<uint8_t> buf(kReadBytes + FrameParser::kMaxFrame);
+    size_t carry = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    bool ok = true;
+    auto sink = [&](uint64_t t, uint8_t ch, uint16_t v) { ok = out.append(t, ch, v) && ok; };
+
+    while (!g_stop) {
+        ssize_t n = ::read(fd, buf.data() + carry, kReadBytes);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;      // EOF, or EIO once a PTY master closes
+        }
+        size_t len = carry + size_t(n);
+        size_t keep = parser.parse(buf.data(), len, sink);
+        if (keep) {
+            std::memmove(buf.data(), buf.data() + len - keep, keep);
+        }
+        carry = keep;
+        out.commit();
+        if (!ok) {
+            std::fprintf(stderr, "write failed\n");
+            res.ok = false;
+            break;
+        }
+        if (max_frames && parser.stats().frames >= max_frames) {
+            break;
+        }
+        if (max_seconds > 0) {
+            std::chrono::duration<double> el = std::chrono::steady_clock::now() - t0;
+            if (el.count() >= max_seconds) {
+                break;
+            }
+        }
+    }
+    std::chrono::duration<double> el = std::chrono::steady_clock::now() - t0;
+    res.seconds = el.count();
+    res.stats = parser.stats();
+    return res;
+}
+
+void print_rate(const RecordResult &r) {
+    double fps = r.seconds > 0 ? double(r.stats.frames) / r.seconds : 0;
+    double bps = r.seconds > 0 ? double(r.stats.bytes) / r.seconds : 0;
+    std::printf("frames %llu  telemetry %llu  bytes %llu  skipped %llu  %.3f s\n",
+                (unsigned long long)r.stats.frames, (unsigned long long)r.stats.telemetry,
+                (unsigned long long)r.stats.bytes,
+                (unsigned long long)r.stats.skipped, r.seconds);
+    std::printf("%.0f frames/s  %.2f MB/s  (%.0fx the 115200 baud link)\n",
+                fps, bps / 1e6, bps / kLinkBytesPerSec);
+}
+
+int cmd_record(int argc, char **argv) {
+    if (argc < 2) {
+        return 2;
+    }
+    long baud = 115200;
+    long rate = 0;
+    uint64_t max_frames = 0;
+    double max_seconds = 0;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (!std::strcmp(argv[i], "-b")) baud = std::atol(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "-r")) rate = std::atol(argv[i + 1]);
+        else if (!std::strcmp(argv[i], "-n")) max_frames = std::strtoull(argv[i + 1], nullptr, 10);
+        else if (!std::strcmp(argv[i], "-s")) max_seconds = std::atof(argv[i + 1]);
+        else return 2;
+    }
+    int fd = ::open(argv[0], (rate ? O_RDWR : O_RDONLY) | O_NOCTTY);
+    if (fd < 0 || !make_raw(fd, baud)) {
+        std::perror(argv[0]);
+        return 1;
+    }
+    if (rate && rate != baud && !baud_constant(rate)) {
+        std::fprintf(stderr, "unsupported baud %ld\n", rate);
+        return 1;
+    }
+    if (rate && rate != baud) {
+        negotiate(fd, baud, rate);
+    }
+    ColumnFile out;
+    if (!out.create(argv[1])) {
+        std::perror(argv[1]);
+        return 1;
+    }
+    std::signal(SIGINT, on_sigint);
+    RecordResult r = record_fd(fd, out, max_frames, max_seconds);
+    ::close(fd);
+    print_rate(r);
+    return r.ok ? 0 : 1;
+}
+
+bool open_or_report(ColumnFile &f, const char *path) {
+    if (!f.open_read(path)) {
+        std::fprintf(stderr, "%s: not a capture file\n", path);
+        return false;
+    }
+    return true;
+}
+
+int cmd_info(int argc, char **argv) {
+    ColumnFile f;
+    if (argc < 1 || !open_or_report(f, argv[0])) {
+        return argc < 1 ? 2 : 1;
+    }
+    std::printf("rows %llu  chunks %llu  chunk_rows %u\n", (unsigned long long)f.rows(),
+                (unsigned long long)f.chunks(), f.chunk_rows());
+    uint64_t used = (f.rows() + f.chunk_rows() - 1) / f.chunk_rows();
+    for (uint64_t i = 0; i < used; ++i) {
+        const ChunkHeader *c = f.chunk(i);
+        std::printf("chunk %llu  rows %u  t %llu..%llu  value %u..%u  ch 0x%x\n",
+                    (unsigned long long)i, c->rows, (unsigned long long)c->first_t,
+                    (unsigned long long)c->last_t, c->min_value, c->max_value, c->channel_mask);
+    }
+    return 0;
+}
+
+void print_rows(const ColumnFile &f, uint64_t first, uint64_t count) {
+    for (uint64_t r = first; r < f.rows() && r < first + count; ++r) {
+        Row row = f.row(r);
+        std::printf("%llu %llu %u %u\n", (unsigned long long)r, (unsigned long long)row.t, row.ch, row.value);
+    }
+}
+
+int cmd_read(int argc, char **argv) {
+    ColumnFile f;
+    if (argc < 2) {
+        return 2;
+    }
+    if (!open_or_report(f, argv[0])) {
+        return 1;
+    }
+    uint64_t count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10;
+    print_rows(f, std::strtoull(argv[1], nullptr, 10), count);
+    return 0;
+}
+
+int cmd_at(int argc, char **argv) {
+    ColumnFile f;
+    if (argc < 2) {
+        return 2;
+    }
+    if (!open_or_report(f, argv[0])) {
+        return 1;
+    }
+    print_rows(f, f.lower_bound(std::strtoull(argv[1], nullptr, 10)), 1);
+    return 0;
+}
+
+// Synthetic stream: a ramp at a fixed device sample spacing, with a
+// console text line every 1000 frames to exercise resync.
+std::vector<uint8_t> synth_stream(uint64_t frames) {
+    std::vector<uint8_t> s;
+    s.reserve(frames * STREAM_FRAME_LEN + frames / 1000 * 32);
+    const char text[] = "\nADC STREAM ON /16 DROP 0\n";
+    for (uint64_t i = 0; i < frames; ++i) {
+        uint16_t stamp = uint16_t(i * 2165);        // ~460 Hz in timestamp counts
+        uint16_t value = uint16_t(i & 0x0FFF);
+        uint8_t f[STREAM_FRAME_LEN] = {STREAM_SYNC, STREAM_CH_A0, uint8_t(stamp), uint8_t(stamp >> 8),
+                                       uint8_t(value), uint8_t(value >> 8), 0};
+        for (int k = 0; k < STREAM_FRAME_LEN - 1; ++k) {
+            f[STREAM_FRAME_LEN - 1] ^= f[k];
+        }
+        s.insert(s.end(), f, f + STREAM_FRAME_LEN);
+        if (i % 1000 == 999) {
+            s.insert(s.end(), text, text + sizeof text - 1);
+        }
+    }
+    return s;
+}
+
+int cmd_bench(int argc, char **argv) {
+    uint64_t frames = argc > 0 ? std::strtoull(argv[0], nullptr, 10) : 2000000;
+    std::vector<uint8_t> stream = synth_stream(frames);
+
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        std::perror("pty");
+        return 1;
+    }
+    int slave = ::open(ptsname(master), O_RDONLY | O_NOCTTY);
+    if (slave < 0 || !make_raw(slave, 0)) {
+        std::perror("pty slave");
+        return 1;
+    }
+    std::string path = "/tmp/capture_bench.col";
+    ColumnFile out;
+    if (!out.create(path)) {
+        std::perror(path.c_str());
+        return 1;
+    }
+
+    std::thread producer([&] {
+        const uint8_t *p = stream.data();
+        size_t left = stream.size();
+        while (left) {
+            ssize_t n = ::write(master, p, std::min<size_t>(left, 4096));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            p += n;
+            left -= size_t(n);
+        }
+        tcdrain(master);
+    });
+
+    RecordResult r = record_fd(slave, out, frames, 0);
+    producer.join();
+    ::close(slave);
+    ::close(master);
+    print_rate(r);
+
+    // Integrity: every frame decoded in order with the right unwrapped time
+    uint64_t bad = 0;
+    for (uint64_t i = 0; i < out.rows(); ++i) {
+        Row row = out.row(i);
+        if (row.value != (i & 0x0FFF) || row.t != i * 2165) {
+            ++bad;
+        }
+    }
+    std::printf("rows %llu  mismatches %llu\n", (unsigned long long)out.rows(), (unsigned long long)bad);
+    bool ok = r.ok && bad == 0 && out.rows() == frames;
+    out.close();
+    std::remove(path.c_str());
+    return ok ? 0 : 1;
+}
+
+void usage() {
+    std::fprintf(stderr,
+                 "usage: capture record <tty> <file> [-b baud] [-r rate] [-n frames] [-s seconds]\n"
+                 "       capture info <file>\n"
+                 "       capture read <file> <row> [count]\n"
+                 "       capture at <file> <t>\n"
+                 "       capture bench [frames]\n");
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        usage();
+        return 2;
+    }
+    std::string cmd = argv[1];
+    int rc = 2;
+    if (cmd == "record") rc = cmd_record(argc - 2, argv + 2);
+    else if (cmd == "info") rc = cmd_info(argc - 2, argv + 2);
+    else if (cmd == "read") rc = cmd_read(argc - 2, argv + 2);
+    else if (cmd == "at") rc = cmd_at(argc - 2, argv + 2);
+    else if (cmd == "bench") rc = cmd_bench(argc - 2, argv + 2);
+    if (rc == 2) {
+        usage();
+    }
+    return rc;
+}
@@ -0,0 +1,196 @@
+#include "colfile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace capture {
+
+namespace {
+
+constexpr char kMagic[8] = "ADCCOL1";
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kChunkMagic = 0x4B4E4843;  // "CHNK"
+
+size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+}  // namespace
+
+ColumnFile::~ColumnFile() { close(); }
+
+void ColumnFile::close() {
+    if (base_) {
+        if (writable_) {
+            commit();
+            msync(base_, mapped_, MS_ASYNC);
+        }
+        munmap(base_, mapped_);
+        base_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool ColumnFile::map(size_t bytes, bool writable) {
+    int prot = PROT_READ | (writable ? PROT_WRITE : 0);
+    void *p;
+    if (base_) {
+        p = mremap(base_, mapped_, bytes, MREMAP_MAYMOVE);
+    } else {
+        p = mmap(nullptr, bytes, prot, MAP_SHARED, fd_, 0);
+    }
+    if (p == MAP_FAILED) {
+        return false;
+    }
+    base_ = static_cast<uint8_t *>(p);
+    mapped_ = bytes;
+    return true;
+}
+
+static void layout(uint32_t rows, size_t &t_off, size_t &ch_off, size_t &value_off, size_t &bytes) {
+    t_off = sizeof(ChunkHeader);
+    ch_off = t_off + align8(sizeof(uint64_t) * rows);
+    value_off = ch_off + align8(rows);
+    bytes = value_off + align8(sizeof(uint16_t) * rows);
+}
+
+bool ColumnFile::create(const std::string &path, uint32_t chunk_rows) {
+    close();
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0 || chunk_rows == 0) {
+        return false;
+    }
+    layout(chunk_rows, t_off_, ch_off_, value_off_, chunk_bytes_);
+    if (ftruncate(fd_, kHeaderBytes) != 0 || !map(kHeaderBytes, true)) {
+        return false;
+    }
+    writable_ = true;
+    FileHeader *h = header();
+    std::memcpy(h->magic, kMagic, sizeof kMagic);
+    h->version = kVersion;
+    h->chunk_rows = chunk_rows;
+    h->rows = 0;
+    h->chunks = 0;
+    pending_rows_ = 0;
+    return true;
+}
+
+bool ColumnFile::open_read(const std::string &path) {
+    close();
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd_ < 0 || fstat(fd_, &st) != 0 || size_t(st.st_size) < kHeaderBytes) {
+        return false;
+    }
+    if (!map(size_t(st.st_size), false)) {
+        return false;
+    }
+    const FileHeader *h = header();
+    if (std::memcmp(h->magic, kMagic, sizeof kMagic) != 0 || h->version != kVersion || h->chunk_rows == 0) {
+        return false;
+    }
+    layout(h->chunk_rows, t_off_, ch_off_, value_off_, chunk_bytes_);
+    if (chunk_offset(h->chunks) > mapped_) {
+        return false;
+    }
+    writable_ = false;
+    return true;
+}
+
+bool ColumnFile::grow() {
+    uint64_t n = header()->chunks + 1;
+    size_t bytes = chunk_offset(n);
+    if (ftruncate(fd_, off_t(bytes)) != 0 || !map(bytes, true)) {
+        return false;
+    }
+    ChunkHeader *c = reinterpret_cast<ChunkHeader *>(base_ + chunk_offset(n - 1));
+    std::memset(c, 0, sizeof *c);
+    c->magic = kChunkMagic;
+    c->min_value = UINT16_MAX;
+    header()->chunks = n;
+    return true;
+}
+
+bool ColumnFile::append(uint64_t t, uint8_t ch, uint16_t value) {
+    uint32_t per = header()->chunk_rows;
+    uint64_t r = pending_rows_;
+    uint64_t ci = r / per;
+    uint32_t i = uint32_t(r % per);
+    if (ci >= header()->chunks && !grow()) {
+        return false;
+    }
+    uint8_t *c = base_ + chunk_offset(ci);
+    reinterpret_cast<uint64_t *>(c + t_off_)[i] = t;
+    c[ch_off_ + i] = ch;
+    reinterpret_cast<uint16_t *>(c + value_off_)[i] = value;
+
+    ChunkHeader *h = reinterpret_cast<ChunkHeader *>(c);
+    if (i == 0) {
+        h->first_t = t;
+    }
+    h->last_t = t;
+    h->rows = i + 1;
+    h->min_value = std::min(h->min_value, value);
+    h->max_value = std::max(h->max_value, value);
+    h->channel_mask |= 1u << (ch & 31);
+    ++pending_rows_;
+    return true;
+}
+
+void ColumnFile::commit() {
+    if (writable_ && base_) {
+        header()->rows = pending_rows_;
+    }
+}
+
+const ChunkHeader *ColumnFile::chunk(uint64_t i) const {
+    return reinterpret_cast<const ChunkHeader *>(base_ + chunk_offset(i));
+}
+
+const uint64_t *ColumnFile::t_column(uint64_t i) const {
+    return reinterpret_cast<const uint64_t *>(base_ + chunk_offset(i) + t_off_);
+}
+
+const uint8_t *ColumnFile::ch_column(uint64_t i) const {
+    return base_ + chunk_offset(i) + ch_off_;
+}
+
+const uint16_t *ColumnFile::value_column(uint64_t i) const {
+    return reinterpret_cast<const uint16_t *>(base_ + chunk_offset(i) + value_off_);
+}
+
+Row ColumnFile::row(uint64_t r) const {
+    uint64_t ci = r / chunk_rows();
+    uint32_t i = uint32_t(r % chunk_rows());
+    return Row{t_column(ci)[i], ch_column(ci)[i], value_column(ci)[i]};
+}
+
+uint64_t ColumnFile::lower_bound(uint64_t t0) const {
+    uint64_t n = rows();
+    if (n == 0) {
+        return 0;
+    }
+    uint64_t used = (n + chunk_rows() - 1) / chunk_rows();
+    // Last chunk whose first_t <= t0 (t is non-decreasing across the file)
+    uint64_t lo = 0, hi = used;
+    while (hi - lo > 1) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (chunk(mid)->first_t <= t0) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    uint64_t base_row = lo * chunk_rows();
+    uint64_t count = std::min<uint64_t>(chunk_rows(), n - base_row);
+    const uint64_t *t = t_column(lo);
+    uint64_t i = uint64_t(std::lower_bound(t, t + count, t0) - t);
+    return base_row + i;
+}
+
+}  // namespace capture
@@ -0,0 +1,95 @@
+// Memory-mapped, column-oriented sample file.
+//
+// Layout (host byte order):
+//   [0, 4096)        FileHeader
+//   chunk i          ChunkHeader, then the t, ch and value columns, each
+//                    sized for chunk_rows and padded to 8 bytes
+//
+// Chunks are fixed size, so row r lives in chunk r / chunk_rows at a
+// computable offset: random access by row is O(1) and by time is a
+// binary search over chunk headers, then over one t column. The file
+// grows one chunk at a time (ftruncate + mremap); rows in the header is
+// the committed count, so a killed capture leaves a readable file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace capture {
+
+struct FileHeader {
+    char magic[8];          // "ADCCOL1"
+    uint32_t version;
+    uint32_t chunk_rows;
+    uint64_t rows;          // committed rows
+    uint64_t chunks;        // allocated chunks
+};
+
+struct ChunkHeader {
+    uint32_t magic;         // 'CHNK'
+    uint32_t rows;
+    uint64_t first_t;
+    uint64_t last_t;
+    uint16_t min_value;
+    uint16_t max_value;
+    uint32_t channel_mask;  // bit per channel seen (0..31)
+    uint8_t reserved[32];
+};
+
+struct Row {
+    uint64_t t;
+    uint8_t ch;
+    uint16_t value;
+};
+
+class ColumnFile {
+public:
+    static constexpr uint32_t kDefaultChunkRows = 65536;
+
+    ColumnFile() = default;
+    ~ColumnFile();
+    ColumnFile(const ColumnFile &) = delete;
+    ColumnFile &operator=(const ColumnFile &) = delete;
+
+    bool create(const std::string &path, uint32_t chunk_rows = kDefaultChunkRows);
+    bool open_read(const std::string &path);
+    void close();
+
+    // Writer: append() stores, commit() publishes the row count.
+    bool append(uint64_t t, uint8_t ch, uint16_t value);
+    void commit();
+
+    uint64_t rows() const { return header()->rows; }
+    uint64_t chunks() const { return header()->chunks; }
+    uint32_t chunk_rows() const { return header()->chunk_rows; }
+    const ChunkHeader *chunk(uint64_t i) const;
+
+    // Column views of one chunk (valid until the next append).
+    const uint64_t *t_column(uint64_t i) const;
+    const uint8_t *ch_column(uint64_t i) const;
+    const uint16_t *value_column(uint64_t i) const;
+
+    Row row(uint64_t r) const;
+    // First row with t >= t0 (rows() if none).
+    uint64_t lower_bound(uint64_t t0) const;
+
+private:
+    FileHeader *header() const { return reinterpret_cast<FileHeader *>(base_); }
+    size_t chunk_offset(uint64_t i) const { return kHeaderBytes + i * chunk_bytes_; }
+    bool map(size_t bytes, bool writable);
+    bool grow();
+
+    static constexpr size_t kHeaderBytes = 4096;
+
+    int fd_ = -1;
+    uint8_t *base_ = nullptr;
+    size_t mapped_ = 0;
+    size_t chunk_bytes_ = 0;
+    size_t t_off_ = 0, ch_off_ = 0, value_off_ = 0;
+    uint64_t pending_rows_ = 0;
+    bool writable_ = false;
+};
+
+}  // namespace capture
@@ -0,0 +1,143 @@
+// Zero-copy decoder for the device's binary sample and telemetry frames
+// (stream.h).
+//
+// Frames are decoded straight out of the caller's read buffer; console
+// text and corrupt bytes around them are skipped by resyncing on either
+// sync byte and checking the XOR. Only a partial frame at the end of a
+// buffer (< TELEM_FRAME_LEN(TELEM_MAX_RECORDS) bytes) is carried over to
+// the next call. Each telemetry record becomes one sample on the channel
+// of its topic, at the frame's timestamp.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+extern "C" {
+#include "stream.h"
+}
+
+namespace capture {
+
+struct ParseStats {
+    uint64_t bytes = 0;
+    uint64_t frames = 0;
+    uint64_t telemetry = 0;     // telemetry frames (also counted in frames)
+    uint64_t skipped = 0;       // bytes outside valid frames
+};
+
+class FrameParser {
+public:
+    // Largest carry-over a caller has to make room for
+    static constexpr size_t kMaxFrame = TELEM_FRAME_LEN(TELEM_MAX_RECORDS);
+
+    // Calls sink(t64, ch, value) for every valid frame in [data, data+len).
+    // Returns the number of trailing bytes the caller must keep and pass
+    // again in front of the next read.
+    template <typename Sink>
+    size_t parse(const uint8_t *data, size_t len, Sink &&sink) {
+        stats_.bytes += len;
+        const uint8_t *p = data;
+        const uint8_t *end = data + len;
+        while (p < end) {
+            const uint8_t *s = find_sync(p, end);
+            if (!s) {
+                stats_.skipped += uint64_t(end - p);
+                return 0;
+            }
+            stats_.skipped += uint64_t(s - p);
+            if (s[0] == TELEM_SYNC) {
+                size_t n = parse_telemetry(s, size_t(end - s), sink);
+                if (n == 0) {
+                    stats_.skipped += 1;
+                    p = s + 1;
+                } else if (n > size_t(end - s)) {
+                    stats_.bytes -= uint64_t(end - s);  // incomplete: counted again next call
+                    return size_t(end - s);
+                } else {
+                    p = s + n;
+                }
+                continue;
+            }
+            if (size_t(end - s) < STREAM_FRAME_LEN) {
+                stats_.bytes -= uint64_t(end - s);      // counted again next call
+                return size_t(end - s);
+            }
+            uint8_t x = s[0] ^ s[1] ^ s[2] ^ s[3] ^ s[4] ^ s[5];
+            if (x != s[6]) {
+                stats_.skipped += 1;
+                p = s + 1;
+                continue;
+            }
+            uint16_t stamp = uint16_t(s[2] | (s[3] << 8));
+            uint16_t value = uint16_t(s[4] | (s[5] << 8));
+            sink(unwrap(stamp), s[1], value);
+            ++stats_.frames;
+            p = s + STREAM_FRAME_LEN;
+        }
+        return 0;
+    }
+
+    const ParseStats &stats() const { return stats_; }
+
+private:
+    static const uint8_t *find_sync(const uint8_t *p, const uint8_t *end) {
+        for (; p < end; ++p) {
+            if (*p == STREAM_SYNC || *p == TELEM_SYNC) {
+                return p;
+            }
+        }
+        return nullptr;
+    }
+
+    // Bytes used by the telemetry frame at s: 0 if it is not one, more
+    // than len if it does not fit yet.
+    template <typename Sink>
+    size_t parse_telemetry(const uint8_t *s, size_t len, Sink &&sink) {
+        if (len < 2) {
+            return len + 1;
+        }
+        uint8_t n = s[1];
+        if (n == 0 || n > TELEM_MAX_RECORDS) {
+            return 0;
+        }
+        size_t flen = TELEM_FRAME_LEN(n);
+        if (len < flen) {
+            return len + 1;
+        }
+        uint8_t x = 0;
+        for (size_t i = 0; i < flen - 1; ++i) {
+            x ^= s[i];
+        }
+        if (x != s[flen - 1]) {
+            return 0;
+        }
+        uint64_t t = unwrap(uint16_t(s[2] | (s[3] << 8)));
+        for (const uint8_t *r = s + TELEM_HEADER_LEN; r < s + flen - 1; r += TELEM_RECORD_LEN) {
+            sink(t, r[0], uint16_t(r[1] | (r[2] << 8)));
+        }
+        ++stats_.frames;
+        ++stats_.telemetry;
+        return flen;
+    }
+
+    // Extend the 16-bit device timestamp; frames must be < 1 wrap apart.
+    uint64_t unwrap(uint16_t stamp) {
+        if (!started_) {
+            started_ = true;
+            t_ = stamp;
+        } else {
+            t_ += uint16_t(stamp - last_);
+        }
+        last_ = stamp;
+        return t_;
+    }
+
+    ParseStats stats_;
+    bool started_ = false;
+    uint16_t last_ = 0;
+    uint64_t t_ = 0;
+};
+
+}  // namespace capture
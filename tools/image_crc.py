@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""Patch the flash-scrub reference CRC into an Intel HEX firmware image.
+
+Computes CRC-16/CCITT (poly 0x1021, seed 0xFFFF, no reflection) over
+main flash 0x4400..0xFFFF with unprogrammed bytes read as 0xFF -- the
+same range and algorithm flash_crc.c runs on the MSP430 CRC16 module --
+and writes {magic, crc} (little-endian) to info segment D at 0x1800.
+
+usage: image_crc.py firmware.hex [patched.hex]
+"""
+
+import sys
+
+SCRUB_START = 0x4400
+SCRUB_END = 0x10000
+REF_ADDR = 0x1800
+IMAGE_CRC_MAGIC = 0x5A3C
+
+
+def read_hex(path):
+    mem = {}
+    base = 0
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith(":"):
+                continue
+            raw = bytes.fromhex(line[1:])
+            count, addr, rtype = raw[0], (raw[1] << 8) | raw[2], raw[3]
+            data = raw[4:4 + count]
+            if rtype == 0x00:
+                for i, b in enumerate(data):
+                    mem[base + addr + i] = b
+            elif rtype == 0x02:
+                base = ((data[0] << 8) | data[1]) << 4
+            elif rtype == 0x04:
+                base = ((data[0] << 8) | data[1]) << 16
+            elif rtype == 0x01:
+                break
+    return mem
+
+
+def write_hex(path, mem):
+    lines = []
+    upper = None
+    addrs = sorted(mem)
+    i = 0
+    while i < len(addrs):
+        start = addrs[i]
+        if start >> 16 != upper:
+            upper = start >> 16
+            rec = bytes([2, 0, 0, 4, upper >> 8, upper & 0xFF])
+            lines.append(record(rec))
+        data = [mem[start]]
+        i += 1
+        while (i < len(addrs) and addrs[i] == start + len(data)
+               and len(data) < 16 and addrs[i] >> 16 == upper):
+            data.append(mem[addrs[i]])
+            i += 1
+        lo = start & 0xFFFF
+        lines.append(record(bytes([len(data), lo >> 8, lo & 0xFF, 0]) + bytes(data)))
+    lines.append(":00000001FF")
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+
+def record(raw):
+    checksum = (-sum(raw)) & 0xFF
+    return ":" + (raw + bytes([checksum])).hex().upper()
+
+
+def crc16_ccitt(data, crc=0xFFFF):
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        sys.stderr.write(__doc__)
+        return 2
+    src = argv[1]
+    dst = argv[2] if len(argv) == 3 else src
+    mem = read_hex(src)
+    image = bytes(mem.get(a, 0xFF) for a in range(SCRUB_START, SCRUB_END))
+    crc = crc16_ccitt(image)
+    for i, b in enumerate((IMAGE_CRC_MAGIC & 0xFF, IMAGE_CRC_MAGIC >> 8,
+                           crc & 0xFF, crc >> 8)):
+        mem[REF_ADDR + i] = b
+    write_hex(dst, mem)
+    print("image CRC 0x%04X over 0x%04X..0x%04X -> %s" % (crc, SCRUB_START, SCRUB_END - 1, dst))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,661 @@
+#!/usr/bin/env python3
+"""Static worst-case execution time bounds for tasks and ISRs.
+
+Reads the linked msp430-gcc ELF, decodes each function's MSP430/MSP430X
+code into basic blocks with cycle counts from the CPUX timing tables of
+the MSP430x5xx/6xx Family User's Guide (SLAU208, "Instruction Cycles and
+Lengths"), collapses loops innermost first with the bounds given in the
+bounds file, and takes the longest path through what is left. Callees
+are added at each call site; recursion is an error.
+
+Bounds file, one directive per line, '#' starts a comment:
+
+  tick <ms>                      tasks + ISRs of one tick must fit in it
+  task <func> [budget_us]        budget defaults to the tick
+  isr  <func> [budget_us|-] [n]  n: worst-case entries per tick (default 1)
+  isr  <func>/<callee> ...       only the entries that call callee: func's
+                                 other direct callees cost nothing (shared
+                                 vectors whose sources run at different rates)
+  loop <func>[+0xoff] <n>        body runs at most n times per entry; without
+                                 +off it covers every loop in func, with it
+                                 the loop whose header is at func+off
+  calls <func> <target>...       targets of func's indirect calls/branches
+  cost <func> <cycles>           use a measured bound instead of decoding
+
+Exits non-zero if any budget is exceeded or a bound could not be
+computed (loop without a bound, unresolved indirect call, irreducible
+control flow, undecodable code); each problem is reported as func+off.
+
+usage: wcet.py firmware.elf [bounds.txt] [--mclk HZ] [-v]
+"""
+
+import struct
+import sys
+
+DEFAULT_MCLK = 1048576          # slow clock (clock.c); boosted runs are faster
+INTERRUPT_ACCEPT = 6            # cycles from request to first ISR instruction
+
+# Format I cycles by source mode, then destination register / PC / memory
+FMT1 = {
+    "REG": (1, 3, 4),
+    "IND": (2, 4, 5),
+    "INC": (2, 4, 5),
+    "IMM": (2, 3, 5),
+    "IDX": (3, 5, 6),
+    "SYM": (3, 5, 6),
+    "ABS": (3, 5, 6),
+}
+FMT1_NOWRITE = ("MOV", "CMP", "BIT")   # one cycle less to a memory destination
+
+# Format II cycles by operand mode
+FMT2 = {
+    "RRx":  {"REG": 1, "IND": 3, "INC": 3, "IDX": 4, "SYM": 4, "ABS": 4},
+    "PUSH": {"REG": 3, "IND": 3, "INC": 3, "IMM": 3, "IDX": 4, "SYM": 4, "ABS": 4},
+    "CALL": {"REG": 4, "IND": 4, "INC": 4, "IMM": 4, "IDX": 5, "SYM": 5, "ABS": 5},
+}
+RETI_CYCLES = 5
+JUMP_CYCLES = 2                 # taken or not
+
+# Address instructions (0x0000-0x0FFF) by bits 7:4; (to Rdst, to PC)
+ADDR_OPS = {
+    0x0: ("MOVA", 3, 4), 0x1: ("MOVA", 3, 4), 0x2: ("MOVA", 4, 5),
+    0x3: ("MOVA", 4, 5), 0x6: ("MOVA", 4, None), 0x7: ("MOVA", 4, None),
+    0x8: ("MOVA", 2, 3), 0x9: ("CMPA", 3, None), 0xA: ("ADDA", 3, None),
+    0xB: ("SUBA", 3, None), 0xC: ("MOVA", 1, 3), 0xD: ("CMPA", 1, None),
+    0xE: ("ADDA", 1, None), 0xF: ("SUBA", 1, None),
+}
+CALLA_CYCLES = {0x4: 5, 0x5: 5, 0x6: 5, 0x7: 5, 0x8: 6, 0x9: 6, 0xB: 5}
+
+FMT1_OPS = ("MOV", "ADD", "ADDC", "SUBC", "SUB", "CMP", "DADD", "BIT",
+            "BIC", "BIS", "XOR", "AND")
+FMT2_OPS = ("RRC", "SWPB", "RRA", "SXT", "PUSH", "CALL")
+
+PC, SP, SR, CG = 0, 1, 2, 3
+
+
+class DecodeError(Exception):
+    pass
+
+
+class Insn:
+    """One decoded instruction; kind drives the CFG.
+
+    seq: falls through   jmp/cjmp: direct jump   br: branch to target
+    ibr: indirect branch (targets may be set from a jump table)
+    call/icall: direct/indirect call   ret/reti: function exit
+    """
+
+    def __init__(self, addr, size, cycles, kind="seq", target=None, text=""):
+        self.addr = addr
+        self.size = size
+        self.cycles = cycles
+        self.kind = kind
+        self.target = target
+        self.targets = None
+        self.text = text
+
+
+# --- ELF -------------------------------------------------------------------
+
+class Elf:
+    """The allocated sections and function symbols of an ELF32 image."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+            raise SystemExit("%s: not a little-endian ELF32 file" % path)
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+        sections = []
+        for i in range(shnum):
+            sections.append(struct.unpack_from("<IIIIIIIIII", data, shoff + i * shentsize))
+
+        def name_at(table, off):
+            start = table[4] + off
+            return data[start:data.index(b"\0", start)].decode()
+
+        self.regions = []       # (start, bytes) of loaded code and data
+        symtab = None
+        for sh in sections:
+            sh_name, sh_type, sh_flags, sh_addr, sh_offset, sh_size = sh[:6]
+            if sh_type == 2:
+                symtab = sh
+            elif sh_type == 1 and sh_flags & 0x2 and sh_size:
+                self.regions.append((sh_addr, data[sh_offset:sh_offset + sh_size]))
+        if symtab is None:
+            raise SystemExit("%s: no symbol table (link without -s)" % path)
+
+        strtab = sections[symtab[6]]
+        self.funcs = {}         # name -> (start, end)
+        for i in range(symtab[5] // 16):
+            st_name, value, size, info, _, shndx = struct.unpack_from(
+                "<IIIBBH", data, symtab[4] + i * 16)
+            if info & 0xF == 2 and size and shndx:
+                self.funcs.setdefault(name_at(strtab, st_name), (value, value + size))
+        self.by_addr = {start: name for name, (start, _) in self.funcs.items()}
+
+    def word(self, addr):
+        for start, blob in self.regions:
+            if start <= addr and addr + 2 <= start + len(blob):
+                return blob[addr - start] | blob[addr - start + 1] << 8
+        raise DecodeError("no code at 0x%X" % addr)
+
+    def func_at(self, addr):
+        return self.by_addr.get(addr)
+
+
+# --- decoder ---------------------------------------------------------------
+
+def operand(reg, mode_bits):
+    """Source addressing mode and whether it takes an extension word."""
+    if reg == CG or (reg == SR and mode_bits >= 2):
+        return "REG", False     # constant generator
+    if mode_bits == 0:
+        return "REG", False
+    if mode_bits == 1:
+        return ("SYM" if reg == PC else "ABS" if reg == SR else "IDX"), True
+    if mode_bits == 2:
+        return "IND", False
+    return ("IMM", True) if reg == PC else ("INC", False)
+
+
+def decode(elf, addr):
+    w = elf.word(addr)
+    if 0x1800 <= w < 0x2000:
+        return decode_extended(elf, addr, w)
+    if w >= 0x4000:
+        return decode_fmt1(elf, addr, w, addr + 2)
+    if w >= 0x2000:
+        cond = (w >> 10) & 7
+        off = w & 0x3FF
+        if off & 0x200:
+            off -= 0x400
+        target = (addr + 2 + 2 * off) & 0xFFFFF
+        return Insn(addr, 2, JUMP_CYCLES, "jmp" if cond == 7 else "cjmp", target, "J")
+    if w >= 0x1400:
+        n = ((w >> 4) & 0xF) + 1
+        wide = not (w & 0x0100)
+        return Insn(addr, 2, 2 + (2 * n if wide else n), text="PUSHM/POPM")
+    if w >= 0x1000:
+        return decode_fmt2(elf, addr, w)
+    return decode_address(elf, addr, w)
+
+
+def decode_fmt1(elf, addr, w, ext_at, ext=None):
+    op = FMT1_OPS[(w >> 12) - 4]
+    src, dst = (w >> 8) & 0xF, w & 0xF
+    smode, sword = operand(src, (w >> 4) & 3)
+    dmem = bool(w & 0x80)
+    size = (ext_at - addr) + 2 * sword + 2 * dmem
+    col = 2 if dmem else (1 if dst == PC else 0)
+    cycles = FMT1[smode][col] - (1 if dmem and op in FMT1_NOWRITE else 0)
+    insn = Insn(addr, size, cycles, text=op)
+    if dst != PC or dmem or op in ("CMP", "BIT"):
+        return insn
+    if op == "MOV" and smode == "INC" and src == SP:
+        insn.kind = "ret"
+    elif op == "MOV" and smode == "IMM":
+        insn.kind = "br"
+        insn.target = elf.word(ext_at) | (((ext >> 7) & 0xF) << 16 if ext else 0)
+    elif op == "MOV" and smode == "IDX":
+        insn.kind = "ibr"
+        insn.target = elf.word(ext_at)          # jump table base
+    elif op == "ADD" and smode in ("REG", "ABS", "IND"):
+        insn.kind = "ibr"                       # computed jump into a JMP list
+        insn.targets = jmp_list(elf, addr + size)
+    else:
+        insn.kind = "ibr"
+    return insn
+
+
+def jmp_list(elf, addr):
+    """Targets of ADD x,PC: the run of JMPs that follows and the code after it."""
+    targets = []
+    while elf.word(addr) & 0xFC00 == 0x3C00:
+        targets.append(addr)
+        addr += 2
+    return targets + [addr]
+
+
+def decode_fmt2(elf, addr, w, ext_at=None):
+    ext_at = ext_at or addr + 2
+    if w == 0x1300:
+        return Insn(addr, 2, RETI_CYCLES, "reti", text="RETI")
+    if w >= 0x1340:
+        form = (w >> 4) & 0xF
+        if form not in CALLA_CYCLES:
+            raise DecodeError("bad CALLA 0x%04X at 0x%X" % (w, addr))
+        if form == 0xB:
+            target = (w & 0xF) << 16 | elf.word(addr + 2)
+            return Insn(addr, 4, CALLA_CYCLES[form], "call", target, "CALLA")
+        size = 4 if form in (0x5, 0x8, 0x9) else 2
+        return Insn(addr, size, CALLA_CYCLES[form], "icall", text="CALLA")
+    op = FMT2_OPS[(w >> 7) & 7]
+    reg = w & 0xF
+    mode, word = operand(reg, (w >> 4) & 3)
+    size = (ext_at - addr) + 2 * word
+    group = "RRx" if op in ("RRC", "SWPB", "RRA", "SXT") else op
+    cycles = FMT2[group].get(mode)
+    if cycles is None:
+        raise DecodeError("bad %s mode at 0x%X" % (op, addr))
+    if op != "CALL":
+        return Insn(addr, size, cycles, text=op)
+    if mode == "IMM":
+        return Insn(addr, size, cycles, "call", elf.word(ext_at), "CALL")
+    return Insn(addr, size, cycles, "icall", text="CALL")
+
+
+def decode_address(elf, addr, w):
+    form = (w >> 4) & 0xF
+    src, dst = (w >> 8) & 0xF, w & 0xF
+    if form in (4, 5):                          # RRCM/RRAM/RLAM/RRUM #n
+        return Insn(addr, 2, ((w >> 10) & 3) + 1, text="ROTM")
+    name, cycles, to_pc = ADDR_OPS[form]
+    size = 4 if form in (0x2, 0x3, 0x6, 0x7, 0x8, 0x9, 0xA, 0xB) else 2
+    if dst != PC or name != "MOVA" or to_pc is None:
+        return Insn(addr, size, cycles, text=name)
+    if form == 0x1 and src == SP:
+        return Insn(addr, size, to_pc, "ret", text="RETA")
+    if form == 0x8:
+        return Insn(addr, size, to_pc, "br", src << 16 | elf.word(addr + 2), "BRA")
+    insn = Insn(addr, size, to_pc, "ibr", text="BRA")
+    if form == 0x3:
+        insn.target = elf.word(addr + 2)
+    return insn
+
+
+def decode_extended(elf, addr, ext):
+    """MSP430X extension word + Format I/II instruction."""
+    w = elf.word(addr + 2)
+    if w >= 0x4000:
+        insn = decode_fmt1(elf, addr, w, addr + 4, ext)
+        registers = not (w & 0x80) and (w >> 4) & 3 == 0
+    elif 0x1000 <= w < 0x1300:
+        insn = decode_fmt2(elf, addr, w, addr + 4)
+        registers = (w >> 4) & 3 == 0
+    else:
+        raise DecodeError("bad extended instruction at 0x%X" % addr)
+    address_word = not (ext & 0x40) and w & 0x40
+    if registers:
+        repeat = 16 if ext & 0x80 else (ext & 0xF) + 1
+        insn.cycles = insn.cycles * repeat + 1
+    else:
+        insn.cycles += 2 if address_word else 1
+    insn.text += "X"
+    return insn
+
+
+# --- control flow ----------------------------------------------------------
+
+class Block:
+    def __init__(self, start):
+        self.start = start
+        self.cycles = 0
+        self.succ = set()
+        self.exit = False
+
+
+class Analysis:
+    def __init__(self, elf, bounds, only=None):
+        self.elf = elf
+        self.bounds = bounds
+        self.only = only        # (func, callee): func's other callees cost 0
+        self.memo = {}
+        self.active = set()
+        self.errors = []
+
+    def error(self, func, addr, msg):
+        start = self.elf.funcs[func][0]
+        self.errors.append("%s+0x%X: %s" % (func, addr - start, msg))
+
+    def wcet(self, func):
+        """Worst-case cycles of func, or None (reason in self.errors)."""
+        if func in self.bounds.cost:
+            return self.bounds.cost[func]
+        if func in self.memo:
+            return self.memo[func]
+        if func in self.active:
+            self.errors.append("%s: recursion, give it a cost" % func)
+            return None
+        if func not in self.elf.funcs:
+            self.errors.append("%s: no such function in the ELF" % func)
+            return None
+        self.active.add(func)
+        result = self.analyse(func)
+        self.active.discard(func)
+        self.memo[func] = result
+        return result
+
+    def callee(self, func, insn):
+        if insn.kind == "call" or insn.kind == "br":
+            name = self.elf.func_at(insn.target)
+            if name is None:
+                self.error(func, insn.addr, "call to 0x%X outside any function" % insn.target)
+                return None
+            if self.only and func == self.only[0] and name != self.only[1]:
+                return 0
+            return self.wcet(name)
+        targets = self.bounds.calls.get(func)
+        if not targets:
+            self.error(func, insn.addr, "indirect call, list its targets with 'calls %s'" % func)
+            return None
+        costs = [self.wcet(t) for t in targets]
+        return None if None in costs else max(costs)
+
+    def decode_func(self, func):
+        start, end = self.elf.funcs[func]
+        insns = {}
+        addr = start
+        while addr < end:
+            insn = decode(self.elf, addr)
+            insns[addr] = insn
+            addr += insn.size
+        for insn in insns.values():
+            if insn.kind == "ibr" and insn.targets is None and insn.target is not None:
+                insn.targets = self.jump_table(insn.target, start, end, insns)
+        return insns
+
+    def jump_table(self, base, start, end, insns):
+        """Words from base that point at instructions of this function."""
+        targets = []
+        try:
+            while True:
+                t = self.elf.word(base + 2 * len(targets))
+                if not (start <= t < end and t in insns):
+                    break
+                targets.append(t)
+        except DecodeError:
+            pass
+        return targets or None
+
+    def analyse(self, func):
+        start, end = self.elf.funcs[func]
+        try:
+            insns = self.decode_func(func)
+        except DecodeError as e:
+            self.errors.append("%s: %s" % (func, e))
+            return None
+
+        leaders = {start}
+        for insn in insns.values():
+            if insn.kind in ("seq", "call", "icall"):
+                continue
+            leaders.add(insn.addr + insn.size)
+            targets = insn.targets or []
+            if insn.kind in ("jmp", "cjmp") or (insn.kind == "br" and start <= insn.target < end):
+                targets = [insn.target]
+            for t in targets:
+                if t not in insns:
+                    self.error(func, insn.addr, "jump to 0x%X leaves the function" % t)
+                    return None
+                leaders.add(t)
+
+        ok = True
+        blocks = {}
+        for addr in sorted(insns):
+            insn = insns[addr]
+            if addr in leaders:
+                block = blocks[addr] = Block(addr)
+            block.cycles += insn.cycles
+            nxt = addr + insn.size
+            kind = insn.kind
+            if kind == "br" and start <= insn.target < end:
+                block.succ.add(insn.target)
+            elif kind in ("call", "icall", "br") or (kind == "ibr" and not insn.targets):
+                cost = self.callee(func, insn)
+                if cost is None:
+                    ok = False
+                else:
+                    block.cycles += cost
+                block.exit = kind in ("br", "ibr")      # tail call
+            elif kind == "ibr":
+                block.succ.update(insn.targets)
+            elif kind in ("ret", "reti"):
+                block.exit = True
+            elif kind in ("jmp", "cjmp"):
+                block.succ.add(insn.target)
+            if kind in ("seq", "call", "icall", "cjmp") and nxt in leaders:
+                block.succ.add(nxt)
+        if not ok:
+            return None
+        return self.longest(func, blocks)
+
+    def longest(self, func, blocks):
+        """Collapse loops innermost first, then the longest entry->exit path."""
+        entry = self.elf.funcs[func][0]
+        loops = natural_loops(blocks, entry)
+        if loops is None:
+            self.errors.append("%s: irreducible control flow" % func)
+            return None
+        ok = True
+        for header in sorted(loops, key=lambda h: len(loops[h])):
+            body = {b for b in loops[header] if b in blocks}
+            n = self.bounds.loop_bound(func, header - entry)
+            if n is None:
+                self.error(func, header, "loop without a bound")
+                ok = False
+                n = 1
+            inside = {b: {s for s in blocks[b].succ if s in body and s != header} for b in body}
+            dist = dag_longest(header, inside, blocks)
+            latches = [b for b in body if header in blocks[b].succ]
+            exits = [b for b in body if blocks[b].exit or blocks[b].succ - body]
+            iteration = max(dist[b] for b in latches)
+            leave = max((dist[b] for b in exits), default=0)
+            merged = blocks[header]
+            merged.cycles = n * iteration + leave
+            merged.exit = any(blocks[b].exit for b in body)
+            merged.succ = set().union(*(blocks[b].succ - body for b in body))
+            for b in body - {header}:
+                del blocks[b]
+        if not ok:
+            return None
+        graph = {b: set(blocks[b].succ) for b in blocks}
+        dist = dag_longest(entry, graph, blocks)
+        ends = [dist[b] for b in dist if blocks[b].exit or not blocks[b].succ]
+        if not ends:
+            self.errors.append("%s: no path to a return" % func)
+            return None
+        return max(ends)
+
+
+def natural_loops(blocks, entry):
+    """header -> body blocks; None if a cycle is not a natural loop."""
+    order = []
+    seen = set()
+    stack = [(entry, iter(sorted(blocks[entry].succ)))]
+    seen.add(entry)
+    while stack:
+        node, it = stack[-1]
+        for s in it:
+            if s not in seen:
+                seen.add(s)
+                stack.append((s, iter(sorted(blocks[s].succ))))
+                break
+        else:
+            order.append(node)
+            stack.pop()
+    order.reverse()                             # reverse postorder
+    index = {b: i for i, b in enumerate(order)}
+    preds = {b: set() for b in order}
+    for b in order:
+        for s in blocks[b].succ:
+            preds[s].add(b)
+
+    dom = {b: set(order) for b in order}
+    dom[entry] = {entry}
+    changed = True
+    while changed:
+        changed = False
+        for b in order[1:]:
+            new = set.intersection(*(dom[p] for p in preds[b])) | {b}
+            if new != dom[b]:
+                dom[b] = new
+                changed = True
+
+    loops = {}
+    for b in order:
+        for s in blocks[b].succ:
+            if index[s] > index[b]:
+                continue
+            if s not in dom[b]:
+                return None                     # retreating edge into no dominator
+            body = loops.setdefault(s, {s})
+            work = [b]
+            while work:
+                n = work.pop()
+                if n not in body:
+                    body.add(n)
+                    work.extend(preds[n])
+    for b in list(blocks):
+        if b not in seen:
+            del blocks[b]                       # unreachable code
+    return loops
+
+
+def dag_longest(entry, graph, blocks):
+    """Longest path cost from entry to each reachable node, node costs included."""
+    order = []
+    seen = {entry}
+    stack = [(entry, iter(graph[entry]))]
+    while stack:
+        node, it = stack[-1]
+        for s in it:
+            if s not in seen:
+                seen.add(s)
+                stack.append((s, iter(graph[s])))
+                break
+        else:
+            order.append(node)
+            stack.pop()
+    dist = {entry: blocks[entry].cycles}
+    for node in reversed(order):
+        for s in graph[node]:
+            cand = dist[node] + blocks[s].cycles
+            if cand > dist.get(s, -1):
+                dist[s] = cand
+    return dist
+
+
+# --- bounds file -----------------------------------------------------------
+
+class Bounds:
+    def __init__(self):
+        self.tick_ms = None
+        self.tasks = []         # (func, budget_us or None)
+        self.isrs = []          # (func, budget_us or None, per_tick)
+        self.loops = {}         # (func, offset or None) -> n
+        self.calls = {}
+        self.cost = {}
+
+    def loop_bound(self, func, offset):
+        n = self.loops.get((func, offset))
+        return n if n is not None else self.loops.get((func, None))
+
+    @staticmethod
+    def read(path):
+        b = Bounds()
+        with open(path) as f:
+            for num, line in enumerate(f, 1):
+                words = line.split("#", 1)[0].split()
+                if not words:
+                    continue
+                try:
+                    b.parse(words)
+                except (ValueError, IndexError):
+                    raise SystemExit("%s:%d: bad directive: %s" % (path, num, line.strip()))
+        return b
+
+    def parse(self, words):
+        kind, args = words[0], words[1:]
+        if kind == "tick":
+            self.tick_ms = float(args[0])
+        elif kind == "task":
+            self.tasks.append((args[0], budget(args[1:])))
+        elif kind == "isr":
+            self.isrs.append((args[0], budget(args[1:]), int(args[2]) if len(args) > 2 else 1))
+        elif kind == "loop":
+            func, _, off = args[0].partition("+")
+            self.loops[(func, int(off, 0) if off else None)] = int(args[1])
+        elif kind == "calls":
+            self.calls.setdefault(args[0], []).extend(args[1:])
+            if len(args) < 2:
+                raise ValueError
+        elif kind == "cost":
+            self.cost[args[0]] = int(args[1])
+        else:
+            raise ValueError
+
+
+def budget(args):
+    """Optional budget in us; '-' keeps the default."""
+    return float(args[0]) if args and args[0] != "-" else None
+
+
+# --- report ----------------------------------------------------------------
+
+def main(argv):
+    args = [a for a in argv[1:] if not a.startswith("-")]
+    mclk = DEFAULT_MCLK
+    verbose = "-v" in argv
+    if "--mclk" in argv:
+        i = argv.index("--mclk")
+        mclk = int(argv[i + 1])
+        args.remove(argv[i + 1])
+    if len(args) not in (1, 2):
+        sys.stderr.write(__doc__)
+        return 2
+    elf = Elf(args[0])
+    bounds = Bounds.read(args[1]) if len(args) == 2 else Bounds()
+    analysis = Analysis(elf, bounds)
+    tick_us = bounds.tick_ms * 1000 if bounds.tick_ms else None
+
+    def us(cycles):
+        return cycles * 1e6 / mclk
+
+    rows = [("task", f, budget, 1, 0) for f, budget in bounds.tasks]
+    rows += [("isr", f, budget, n, INTERRUPT_ACCEPT) for f, budget, n in bounds.isrs]
+    if not rows:
+        rows = [("func", f, None, 1, 0) for f in sorted(elf.funcs)]
+
+    analyses = [analysis]
+    failed = False
+    total = 0
+    print("%-5s %-24s %9s %10s %10s" % ("", "function", "cycles", "us", "budget"))
+    for kind, func, budget, per_tick, extra in rows:
+        target, _, callee = func.partition("/")
+        if callee:
+            analyses.append(Analysis(elf, bounds, (target, callee)))
+        cycles = analyses[-1 if callee else 0].wcet(target)
+        if budget is None and kind == "task":
+            budget = tick_us
+        if cycles is None:
+            print("%-5s %-24s %9s" % (kind, func, "?"))
+            failed = True
+            continue
+        cycles += extra
+        total += cycles * per_tick
+        verdict = ""
+        if budget is not None:
+            over = us(cycles) > budget
+            failed |= over
+            verdict = "OVER" if over else "ok"
+        print("%-5s %-24s %9d %10.1f %10s %s" % (
+            kind, func, cycles, us(cycles),
+            "%.0f" % budget if budget is not None else "-", verdict))
+    if tick_us is not None and rows[0][0] != "func":
+        over = us(total) > tick_us
+        failed |= over
+        print("%-5s %-24s %9d %10.1f %10.0f %s" % (
+            "tick", "tasks + ISRs", total, us(total), tick_us, "OVER" if over else "ok"))
+    print("MCLK %d Hz" % mclk)
+    if verbose:
+        for func in sorted(analysis.memo):
+            print("  %-28s %s" % (func, analysis.memo[func]))
+    for e in sorted(set(e for a in analyses for e in a.errors)):
+        sys.stderr.write("wcet: %s\n" % e)
+    return 1 if failed or any(a.errors for a in analyses) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -3,9 +3,12 @@
  * @brief Simple UART driver with double-buffered RX command input.
  *
  * Features:
- * - USCI A1 UART at 115200 baud on P4.4 (TX) / P4.5 (RX)
+ * - USCI A1 UART at 115200 baud on P4.4 (TX) / P4.5 (RX); uart_set_baud()
+ *   for the rates negotiated by BAUD (baud.c)
  * - Blocking TX helpers: uart_putc(), uart_puts()
  * - Line-based RX into a double buffer, consumed via consume_command()
+ * - Loopback mode: wire RX ignored, TX discarded, lines injected with
+ *   uart_inject() go through the same RX path as the ISR (used by BENCH)
  */
 
 #include <msp430.h>
@@ -13,9 +16,12 @@
 #include "string.h"
 #include <stdio.h>
 #include <stdbool.h>
+#include "clock.h"
+#include "record.h"
 
 
 #define UART_BUFFER_SIZE 64 
+#define UART_BAUD 115200UL
 
 /* Double buffers for received commands */
 static char buffer_a[UART_BUFFER_SIZE];
@@ -31,29 +37,89 @@ static  char * volatile isr_buffer = buffer_b;
 
 static volatile int isr_index = 0;
 static volatile bool command_ready = false;
+static bool loopback = false;
+static uint32_t baud = UART_BAUD;
+
+/*
+ * Low-frequency baud generation (UCOS16 = 0): N = f_SMCLK / baud,
+ * UCBRx = floor(N), UCBRSx = round(frac(N) * 8). Gives UCBR = 9,
+ * UCBRS = 1 at 1.048576 MHz / 115200, matching the User's Guide table.
+ */
+static void set_baud_divisors(uint32_t smclk_hz, uint32_t baud){
+  uint32_t n8 = (smclk_hz * 8UL + baud / 2UL) / baud;
+  uint16_t br = (uint16_t)(n8 >> 3);
+  UCA1BR0 = br & 0xFF;
+  UCA1BR1 = br >> 8;
+  UCA1MCTL = (uint8_t)(UCBRS0 * (n8 & 7)) | UCBRF_0;
+}
 
 /**
  * Initialize USCI A1 for UART operation at 115200 baud using SMCLK.
- * P4.4 is configured as TX, P4.5 as RX, and RX interrupt is enabled.
+ * The module is left in reset with the pins parked; uart_start() (first
+ * PERIPH_USCI_A1 client) routes P4.4 TX / P4.5 RX and enables RX.
  */
 void uart_init(){
   UCA1CTL1 |= UCSWRST;      /* Hold USCI A1 in reset while configuring */
   UCA1CTL1 |= UCSSEL__SMCLK;    
 
- /* Configure P4.4 / P4.5 for UART */
+  set_baud_divisors(clock_smclk_hz(), baud);
+  uart_stop();
+}
+
+/* Configure P4.4 / P4.5 for UART, release from reset and enable RX interrupt */
+void uart_start(){
   P4SEL |= BIT4 + BIT5; 
   P4DIR |= BIT4;
-   /* 1 MHz SMCLK, 115200 baud (per User's Guide) */ 
-  UCA1BR0 = 9;                              
-  UCA1BR1 = 0;                              
-  UCA1MCTL = UCBRS_1 + UCBRF_0;
-  
-  /* Release from reset and enable RX interrupt */       
   UCA1CTL1 &= ~UCSWRST;
-  UCA1IE |= UCRXIE; 
+  if (!loopback) {
+    UCA1IE |= UCRXIE;
+  }
+}
+
+/*
+ * Finish the current character, hold the USCI in reset (drops its SMCLK
+ * request) and park the pins: TX driven high (line idle), RX plain input.
+ */
+void uart_stop(){
+  if (!(UCA1CTL1 & UCSWRST)) {
+    uart_tx_flush();
+  }
+  UCA1CTL1 |= UCSWRST;
+  P4OUT |= BIT4;
+  P4DIR |= BIT4;
+  P4DIR &= ~BIT5;
+  P4SEL &= ~(BIT4 + BIT5);
+}
+
+/* Recompute divisors after an SMCLK change; TX must already be idle */
+void uart_clock_changed(){
+  bool running = !(UCA1CTL1 & UCSWRST);
+  UCA1CTL1 |= UCSWRST;
+  set_baud_divisors(clock_smclk_hz(), baud);
+  if (running) {
+    UCA1CTL1 &= ~UCSWRST;
+    if (!loopback) {
+      UCA1IE |= UCRXIE;             /* UCSWRST cleared the enable */
+    }
+  }
+}
+
+/* Change the line rate after pending TX has left at the old one */
+void uart_set_baud(uint32_t rate){
+  uart_tx_flush();
+  baud = rate;
+  uart_clock_changed();
+}
+
+/* Wait until the last character has left the shift register */
+void uart_tx_flush(){
+  while (UCA1STAT & UCBUSY);
 }
 
 void uart_putc(char c){
+  if (loopback) {
+    return;                      /* TX discarded while in loopback */
+  }
   while (!(UCA1IFG&UCTXIFG));    /* wait for TX buffer to be ready */
   UCA1TXBUF = c;  
 }
@@ -67,9 +133,74 @@ void uart_puts(const char* c) {
 
 void uart_put_uint16(const uint16_t v){
   char buf[6];
-  snprintf(buf, sizeof buf, "%d", v);
+  snprintf(buf, sizeof buf, "%u", v);
+  uart_puts(buf);
+
+}
+
+void uart_put_uint32(const uint32_t v){
+  char buf[11];
+  snprintf(buf, sizeof buf, "%lu", (unsigned long)v);
   uart_puts(buf);
+}
+
+void uart_put_hex16(const uint16_t v){
+  static const char hex[] = "0123456789ABCDEF";
+  for (int8_t shift = 12; shift >= 0; shift -= 4) {
+    uart_putc(hex[(v >> shift) & 0xF]);
+  }
+}
+
+bool uart_tx_ready(){
+  return (UCA1IFG & UCTXIFG) != 0;
+}
 
+uint32_t uart_baud(){
+  return baud;
+}
+
+/* Receive one character into the ISR-side buffer (ISR or loopback context) */
+static void rx_char(char c){
+  if (command_ready) {
+    /* Previous command not yet consumed; drop input or implement a queue */
+    return;
+  }
+  if (c == '\n' || c == '\r') {
+    isr_buffer[isr_index] = '\0';
+    command_ready = true;
+  }
+  else if (isr_index < UART_BUFFER_SIZE - 1) {
+    /* Store character and advance index, keeping one slot for '\0' */
+    isr_buffer[isr_index++] = c; 
+  }
+}
+
+/**
+ * Enter/leave loopback mode. Entering waits for pending TX to finish,
+ * then disables the RX interrupt and discards further TX so injected
+ * traffic never reaches the wire.
+ */
+void uart_loopback(bool on){
+  if (on) {
+    uart_tx_flush();             /* let the last character leave */
+    UCA1IE &= ~UCRXIE;
+    loopback = true;
+  } else {
+    loopback = false;
+    UCA1IE |= UCRXIE;
+  }
+}
+
+/* Feed a line plus terminator through the RX path; loopback mode only */
+void uart_inject(const char* line){
+  if (!loopback) {
+    return;
+  }
+  while (*line != '\0') {
+    rx_char(*line);
+    ++line;
+  }
+  rx_char('\n');
 }
 
 
@@ -88,6 +219,7 @@ char * consume_command(){
     }
    else {
           /* Disable UART RX interrupt while swapping buffers */
+          uint8_t rxie = UCA1IE & UCRXIE;
           UCA1IE &= ~UCRXIE;
 
           char *tmp = main_buffer;
@@ -96,8 +228,8 @@ char * consume_command(){
           isr_index = 0;            
           command_ready = false;
           
-          /* Re‑enable UART RX interrupt */    
-          UCA1IE |= UCRXIE;
+          /* Restore UART RX interrupt (stays off in loopback) */    
+          UCA1IE |= rxie;
           
           return main_buffer;
 
@@ -120,18 +252,8 @@ __interrupt void USCI_A1_ISR(void)
   case 2:  {                              // Vector 2 - RXIFG
   /* RXIFG: receive character */
     char c = UCA1RXBUF;
-      if (command_ready) {
-       /* Previous command not yet consumed; drop input or implement a queue */
-        break;
-    }
-    if (c == '\n' || c == '\r') {
-      isr_buffer[isr_index] = '\0';
-      command_ready = true;
-    }
-    else if (isr_index < UART_BUFFER_SIZE - 1) {
-          /* Store character and advance index, keeping one slot for '\0' */
-        isr_buffer[isr_index++] = c; 
-    }   
+    RECORD_INPUT(REC_SRC_UART, (uint8_t)c);
+    rx_char(c);
     break;
   }
   case 4:break;  /* TXIFG: not used */
@@ -2,11 +2,24 @@
 #define UART_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 void uart_init(void);
+void uart_start(void);
+void uart_stop(void);
+void uart_clock_changed(void);
+void uart_set_baud(uint32_t);
+void uart_tx_flush(void);
 void uart_putc(char);
 void uart_puts(const char*);
 void uart_put_uint16(const uint16_t);
+void uart_put_uint32(const uint32_t);
+void uart_put_hex16(const uint16_t);
+bool uart_tx_ready(void);
+uint32_t uart_baud(void);
+
+void uart_loopback(bool);
+void uart_inject(const char*);
 
 char * consume_command();
 
@@ -0,0 +1,31 @@
+/**
+ * @file usbram.c
+ * @brief The USB endpoint buffer RAM as general-purpose buffer space.
+ *
+ * The F5529's 2 KB USB buffer RAM is plain CPU RAM, clocked by MCLK with
+ * no wait states, as long as the USB module is disabled (USB_EN = 0).
+ * With USB_EN = 1 it belongs to the USB controller and reads as garbage
+ * from the CPU side. Reset leaves USB off, but a USB BSL entry or a
+ * debugger session can leave it on, so startup forces the module and its
+ * PLL off before anything touches the section. The firmware never uses
+ * USB, so the module stays off from then on.
+ *
+ * Used by the ADC stream queue, the input recording log and BENCH RAM.
+ */
+
+#include "usbram.h"
+#include <msp430.h>
+#include <string.h>
+
+/* First init stage: USB off, then clear the (NOLOAD) section */
+void usbram_init() {
+    USBKEYPID = USBKEY;             /* unlock the USB configuration */
+    USBCNF &= ~USB_EN;
+    USBPLLCTL &= ~UPLLEN;
+    USBKEYPID = 0;                  /* lock */
+    memset(__usbram_start, 0, (size_t)(__usbram_end - __usbram_start));
+}
+
+uint16_t usbram_used() {
+    return (uint16_t)(__usbram_end - __usbram_start);
+}
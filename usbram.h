@@ -0,0 +1,22 @@
+#ifndef USBRAM_H
+#define USBRAM_H
+
+#include <stdint.h>
+
+/*
+ * Place a buffer in the 2 KB USB endpoint RAM (0x1C00-0x23FF) instead of
+ * the main 8 KB. usbram.ld collects the .usbram section there; it is not
+ * loaded or zeroed by the C startup, so usbram_init() clears it and
+ * buffers must not rely on initializers.
+ */
+#define USBRAM __attribute__((section(".usbram")))
+
+extern uint8_t __usbram_start[];
+extern uint8_t __usbram_end[];
+
+#define USBRAM_SIZE 2048u
+
+void usbram_init();
+uint16_t usbram_used();
+
+#endif